@@ -1,30 +1,66 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include "common.h"
+#include "strategy.h"
+#include "proxy_proto.h"
+#include "turnsync.h"
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
+// Jugador puente: la decisión la toma un motor externo de larga vida (proxy_proto.h) al que
+// se le mandan solo las celdas que cambiaron. Después de cada movimiento se le manda el
+// estado predicho para que piense mientras el máster procesa; si al llegar el turno la
+// predicción sigue valiendo se usa esa respuesta sin esperar. Si el motor no contesta a
+// tiempo (o murió) se juega greedy localmente.
 static game_state_t *game_state = NULL;
 static game_sync_t *game_sync = NULL;
 static int player_id = -1;
-// Para estrategia de un solo jugador
-// Estado single-player: recorrido de perímetros (clockwise) dynamic
-static int sp_initialized = 0;
-static int sp_finished = 0;
-static unsigned int sp_turn = 0;
-static unsigned char sp_dir = DIR_RIGHT; // dirección cardinal actual
+
+static int engine_fd = INVALID_FD;
+static pid_t engine_pid = -1;
+static bool engine_ready = false;          // Ya recibió el INIT
+static int *engine_board = NULL;           // Lo que el motor cree que es el tablero
+static proxy_player_pos_t engine_players[MAX_PLAYERS];
+static unsigned char *delta_buffer = NULL; // Payload de DELTA (peor caso: todas las celdas)
+static int *current_board = NULL;          // Copia local del tablero en cada turno
+static uint32_t next_seq = 1;
+
+static unsigned long engine_moves = 0;
+static unsigned long speculative_hits = 0;
+static unsigned long fallback_moves = 0;
+
+extern char **environ;
 
 /*
  desmapear (con munmap) las regiones de memoria que el proceso mapeó con mmap
 */
 void cleanup_player(void)
 {
+    if (engine_fd != INVALID_FD)
+    {
+        proxy_send(engine_fd, PROXY_MSG_END, 0, next_seq++, NULL, 0);
+        close(engine_fd);
+        engine_fd = INVALID_FD;
+    }
+    if (engine_pid > 0)
+    {
+        waitpid(engine_pid, NULL, 0); // Al cerrar el socket el motor lee EOF y termina
+        engine_pid = -1;
+    }
+    free(engine_board);
+    free(current_board);
+    free(delta_buffer);
+    engine_board = current_board = NULL;
+    delta_buffer = NULL;
     cleanup_shared_memory(game_state, game_sync);
-    // limpear el pipe del mismo
-    // nada dinámico ahora
 }
 
 void signal_handler(int sig)
 {
     (void)sig;
+    if (engine_pid > 0)
+        kill(engine_pid, SIGTERM);
     cleanup_player();
     exit(EXIT_FAILURE);
 }
@@ -42,33 +78,213 @@ int find_player_id(void)
     pid_t my_pid = getpid();
 
     // Leer estado para encontrar nuestro ID
-    sem_wait(&game_sync->reader_count_mutex);
-    game_sync->reader_count++;
-    if (game_sync->reader_count == 1)
-    {
-        sem_wait(&game_sync->state_mutex);
-    }
-    sem_post(&game_sync->reader_count_mutex);
+    read_lock_state(game_sync);
 
     int id = -1;
     for (unsigned int i = 0; i < game_state->player_count; i++)
     {
-        if (game_state->players[i].pid == my_pid)
+        if (PLAYER_PID(game_state, i) == my_pid)
         {
             id = i;
             break;
         }
     }
 
-    sem_wait(&game_sync->reader_count_mutex);
-    game_sync->reader_count--;
-    if (game_sync->reader_count == 0)
+    read_unlock_state(game_sync);
+
+    return id;
+}
+
+// Motor ya escuchando en PROXY_SOCKET_ENV, o uno propio lanzado con un socketpair como
+// stdin (su stdout va a stderr: el nuestro es el pipe de movimientos hacia el máster)
+int connect_engine(void)
+{
+    const char *socket_path = getenv(PROXY_SOCKET_ENV);
+    if (socket_path && *socket_path)
     {
-        sem_post(&game_sync->state_mutex);
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1)
+            return -1;
+        struct sockaddr_un addr = {.sun_family = AF_UNIX};
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+        {
+            close(fd);
+            return -1;
+        }
+        return fd;
     }
-    sem_post(&game_sync->reader_count_mutex);
 
-    return id;
+    const char *engine_path = getenv(PROXY_ENGINE_ENV);
+    if (!engine_path || !*engine_path)
+        engine_path = DEFAULT_PROXY_ENGINE;
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == -1)
+        return -1;
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, sv[1], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, STDERR_FILENO, STDOUT_FILENO);
+    char *const argv[] = {(char *)engine_path, NULL};
+    int err = posix_spawn(&engine_pid, engine_path, &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(sv[1]);
+    if (err != 0)
+    {
+        engine_pid = -1;
+        close(sv[0]);
+        errno = err;
+        return -1;
+    }
+    return sv[0];
+}
+
+void engine_lost(const char *why)
+{
+    fprintf(stderr, "[proxy %d] engine %s, playing greedy from now on\n", player_id, why);
+    close(engine_fd);
+    engine_fd = INVALID_FD;
+}
+
+int send_init(int width, int height)
+{
+    size_t cells = BOARD_CELLS(width, height);
+    uint32_t length = 4 * sizeof(uint32_t) + cells * sizeof(int32_t);
+    unsigned char *payload = malloc(length);
+    if (!payload)
+        return -1;
+
+    uint32_t fields[4] = {width, height, game_state->player_count, player_id};
+    memcpy(payload, fields, sizeof(fields));
+    memcpy(payload + sizeof(fields), current_board, cells * sizeof(int32_t));
+    memcpy(engine_board, current_board, cells * sizeof(int));
+
+    int result = proxy_send(engine_fd, PROXY_MSG_INIT, 0, next_seq++, payload, length);
+    free(payload);
+    return result;
+}
+
+// Manda las diferencias entre el estado dado y lo que ya tiene el motor. Devuelve el seq del
+// pedido, 0 si no hacía falta (el motor ya tiene exactamente ese estado) o -1 si falló.
+long send_delta(const proxy_player_pos_t *players, int cells, uint8_t flags, bool force)
+{
+    unsigned int count = game_state->player_count;
+    unsigned char *cursor = delta_buffer;
+
+    uint32_t player_count = count;
+    memcpy(cursor, &player_count, sizeof(player_count));
+    cursor += sizeof(player_count);
+    memcpy(cursor, players, count * sizeof(proxy_player_pos_t));
+    cursor += count * sizeof(proxy_player_pos_t);
+
+    unsigned char *count_field = cursor;
+    cursor += sizeof(uint32_t);
+    uint32_t changes = 0;
+
+    // Comparación por bloques: la gran mayoría del tablero no cambia entre turnos
+    const int block = 64;
+    for (int base = 0; base < cells; base += block)
+    {
+        int len = cells - base < block ? cells - base : block;
+        if (memcmp(current_board + base, engine_board + base, len * sizeof(int)) == 0)
+            continue;
+        for (int i = base; i < base + len; i++)
+        {
+            if (current_board[i] == engine_board[i])
+                continue;
+            proxy_cell_change_t change = {(uint32_t)i, current_board[i]};
+            memcpy(cursor, &change, sizeof(change));
+            cursor += sizeof(change);
+            engine_board[i] = current_board[i];
+            changes++;
+        }
+    }
+    memcpy(count_field, &changes, sizeof(changes));
+
+    bool players_changed = memcmp(players, engine_players, count * sizeof(proxy_player_pos_t)) != 0;
+    if (!force && changes == 0 && !players_changed)
+        return 0;
+    memcpy(engine_players, players, count * sizeof(proxy_player_pos_t));
+
+    uint32_t seq = next_seq++;
+    if (proxy_send(engine_fd, PROXY_MSG_DELTA, flags, seq, delta_buffer, cursor - delta_buffer) == -1)
+        return -1;
+    return seq;
+}
+
+static bool target_free(const player_t *me, unsigned char dir)
+{
+    if (dir >= DIRECTIONS_COUNT)
+        return false;
+    int dx, dy;
+    get_direction_offset(dir, &dx, &dy);
+    int x = me->x + dx, y = me->y + dy;
+    if (x < 0 || x >= game_state->width || y < 0 || y >= game_state->height)
+        return false;
+    int value = current_board[BOARD_INDEX(game_state->width, x, y)];
+    return value >= MIN_REWARD && value <= MAX_REWARD;
+}
+
+// Espera hasta el deadline una respuesta útil: la del pedido real (real_seq) o la
+// especulativa (spec_seq) si su destino sigue libre en el tablero real. -1 si no llega.
+int await_move(uint32_t spec_seq, uint32_t real_seq, uint64_t deadline_ns, const player_t *me)
+{
+    while (engine_fd != INVALID_FD)
+    {
+        uint64_t now = monotonic_ns();
+        if (now >= deadline_ns)
+            return -1;
+
+        struct pollfd pfd = {engine_fd, POLLIN, 0};
+        int timeout_ms = (int)((deadline_ns - now + NS_PER_MS - 1) / NS_PER_MS);
+        int ready = poll(&pfd, 1, timeout_ms);
+        if (ready == -1 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            return -1;
+
+        proxy_msg_header_t header;
+        unsigned char payload[16];
+        if (proxy_recv_header(engine_fd, &header) == -1 || header.length > sizeof(payload) ||
+            proxy_recv_payload(engine_fd, payload, header.length) == -1)
+        {
+            engine_lost("disconnected");
+            return -1;
+        }
+        if (header.type != PROXY_MSG_MOVE || header.length < 1)
+            continue;
+
+        unsigned char dir = payload[0];
+        if (real_seq && header.seq == real_seq)
+            return dir;
+        if (spec_seq && header.seq == spec_seq && target_free(me, dir))
+        {
+            speculative_hits++;
+            return dir;
+        }
+        // Respuesta vieja o especulación que ya no vale: seguir esperando
+    }
+    return -1;
+}
+
+// Estado del turno: tablero en current_board, posiciones en players
+void copy_state(player_t *me, proxy_player_pos_t *players, bool *game_finished, bool *blocked)
+{
+    read_lock_state(game_sync);
+
+    *game_finished = game_state->game_finished;
+    *blocked = PLAYER_BLOCKED(game_state, player_id);
+    get_player(game_state, player_id, me);
+    memcpy(current_board, game_state->board, sizeof(int) * BOARD_CELLS(game_state->width, game_state->height));
+    for (unsigned int i = 0; i < game_state->player_count; i++)
+    {
+        players[i] = (proxy_player_pos_t){
+            .x = PLAYER_X(game_state, i), .y = PLAYER_Y(game_state, i), .blocked = PLAYER_BLOCKED(game_state, i)};
+    }
+
+    read_unlock_state(game_sync);
 }
 
 int main(int argc, char *argv[])
@@ -94,8 +310,10 @@ int main(int argc, char *argv[])
     }
 
     connect_shared_memory_player(width, height);
-    // Encontrar nuestro ID de jugador
-    player_id = find_player_id();
+    // Encontrar nuestro ID de jugador: el máster lo pasa por entorno, si no se busca por pid
+    player_id = player_id_from_env(game_state);
+    if (player_id == -1)
+        player_id = find_player_id();
     if (player_id == -1)
     {
         fprintf(stderr, "Could not find player ID\n");
@@ -103,69 +321,99 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    int status;
+    int cells = (int)BOARD_CELLS(width, height);
+    current_board = malloc(cells * sizeof(int));
+    engine_board = malloc(cells * sizeof(int));
+    delta_buffer = malloc(2 * sizeof(uint32_t) + MAX_PLAYERS * sizeof(proxy_player_pos_t) +
+                          (size_t)cells * sizeof(proxy_cell_change_t));
+    if (!current_board || !engine_board || !delta_buffer)
+    {
+        cleanup_player();
+        error_exit("malloc proxy buffers");
+    }
 
-    int child_pid = fork();
-    if(child_pid<0)
-        error_exit("proxy_player");
-    if(child_pid==0) // hijo
-        execl("/bin/true", "/bin/true", NULL);
+    const char *deadline_env = getenv(PROXY_DEADLINE_ENV);
+    uint64_t deadline = (deadline_env ? atol(deadline_env) : DEFAULT_PROXY_DEADLINE_MS) * NS_PER_MS;
 
-    waitpid(child_pid, &status, 0);
-    
+    engine_fd = connect_engine();
+    if (engine_fd == -1)
+        perror("[proxy] connect_engine");
+
+    uint32_t spec_seq = 0; // Pedido especulativo pendiente (0 = ninguno)
+    int spec_x = -1, spec_y = -1; // Posición que asumió la especulación
+    proxy_player_pos_t players[MAX_PLAYERS];
 
     while (true)
     {
         // Esperar permiso para moverse
-        sem_wait(&game_sync->player_can_move[player_id]);
+        turn_wait(game_sync, player_id);
 
-        sem_wait(&game_sync->reader_count_mutex);
-        game_sync->reader_count++;
-        if (game_sync->reader_count == 1)
-        {
-            sem_wait(&game_sync->state_mutex);
-        }
-        sem_post(&game_sync->reader_count_mutex);
+        player_t my_player;
+        bool game_finished, blocked;
+        copy_state(&my_player, players, &game_finished, &blocked);
 
-        // Copia todo el estado necesario en variables locales
-        bool game_finished = game_state->game_finished;
-        bool blocked = game_state->players[player_id].blocked;
-
-        // Copiar datos del jugador actual
-        player_t my_player = game_state->players[player_id];
-
-        // Copiar tablero a buffer local (solo lo necesario)
-        int local_board[game_state->width * game_state->height];
-        memcpy(local_board, game_state->board, sizeof(int) * game_state->width * game_state->height);
-
-        // Copiar dimensiones
-        int board_width = game_state->width;
-        int board_height = game_state->height;
+        //verifico si se bloqueo en la eleccion del movimiento
+        if (game_finished || blocked)
+            break;
 
-        // Termino de leer
-        sem_wait(&game_sync->reader_count_mutex);
-        game_sync->reader_count--;
-        if (game_sync->reader_count == 0)// si es el ultimo libero el mutex 
+        uint64_t turn_start = monotonic_ns();
+        int move = -1;
+        if (engine_fd != INVALID_FD && !engine_ready)
         {
-            sem_post(&game_sync->state_mutex);
+            if (send_init(width, height) == -1)
+                engine_lost("rejected INIT");
+            engine_ready = true;
         }
-        sem_post(&game_sync->reader_count_mutex);
-
-        unsigned char move = 0;
-        if (!game_finished && !blocked)
+        // Si nuestro movimiento no se aplicó como se predijo, la respuesta especulativa es
+        // relativa a otra posición y no sirve
+        if (my_player.x != spec_x || my_player.y != spec_y)
+            spec_seq = 0;
+        if (engine_fd != INVALID_FD)
         {
-            move = status;
+            // Si la predicción fue exacta no hace falta un pedido nuevo
+            long real_seq = send_delta(players, cells, 0, spec_seq == 0);
+            if (real_seq == -1)
+                engine_lost("write failed");
+            else
+                move = await_move(spec_seq, (uint32_t)real_seq, turn_start + deadline, &my_player);
+            if (move != -1)
+                engine_moves++;
+        }
+        if (move == -1)
+        {
+            board_view_t board = {current_board, width, height, game_state->player_count, NULL};
+            move = greedy_strategy.choose(&board, &my_player, NULL);
+            fallback_moves++;
         }
 
-        //verifico si se bloqueo en la eleccion del movimiento
-        if (game_finished || blocked)
-            break;
+        unsigned char byte = (unsigned char)move;
+        bool predicted_valid = target_free(&my_player, byte);
 
         // Enviar movimiento al master
-        if (write(STDOUT_FILENO, &move, 1) != 1)
+        if (write(STDOUT_FILENO, &byte, 1) != 1)
             break; // Error o pipe cerrado
+
+        // Especulación: el motor piensa sobre el estado con nuestro movimiento aplicado
+        spec_seq = 0;
+        if (engine_fd != INVALID_FD && predicted_valid)
+        {
+            int dx, dy;
+            get_direction_offset(byte, &dx, &dy);
+            players[player_id].x += dx;
+            players[player_id].y += dy;
+            spec_x = players[player_id].x;
+            spec_y = players[player_id].y;
+            current_board[BOARD_INDEX(width, spec_x, spec_y)] = -player_id;
+            long seq = send_delta(players, cells, PROXY_FLAG_SPECULATIVE, true);
+            if (seq == -1)
+                engine_lost("write failed");
+            else
+                spec_seq = (uint32_t)seq;
+        }
     }
 
+    fprintf(stderr, "[proxy %d] engine=%lu speculative=%lu fallback=%lu\n", player_id, engine_moves,
+            speculative_hits, fallback_moves);
     cleanup_player();
     return 0;
 }
@@ -0,0 +1,287 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "board_gen.h"
+#include <pthread.h>
+
+// Constantes de Philox4x32 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+// Streams independientes dentro del mismo seed
+#define STREAM_BOARD 0
+#define STREAM_CLUSTERS 1
+
+#define CLUSTER_AREA 256 // Una zona de recompensa cada tantas celdas
+#define MAX_CLUSTERS 16
+#define NOISE_SPAN 3 // Ruido en [-1, 1] sobre gradiente y clusters
+
+typedef struct
+{
+    int x, y;
+} cluster_t;
+
+typedef struct
+{
+    game_state_t *state;
+    const board_gen_t *gen;
+    cluster_t clusters[MAX_CLUSTERS];
+    int cluster_count;
+    int cluster_radius;
+} gen_context_t;
+
+typedef struct
+{
+    const gen_context_t *ctx;
+    int first_row;
+    int last_row; // exclusivo
+} gen_task_t;
+
+void philox4x32(const uint32_t counter[PHILOX_WORDS], uint32_t key0, uint32_t key1, uint32_t out[PHILOX_WORDS])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++)
+    {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t hi0 = p0 >> 32, lo0 = (uint32_t)p0;
+        uint32_t hi1 = p1 >> 32, lo1 = (uint32_t)p1;
+
+        c0 = hi1 ^ c1 ^ key0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ key1;
+        c3 = lo0;
+
+        key0 += PHILOX_W0;
+        key1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+int parse_rng_kind(const char *name, rng_kind_t *kind)
+{
+    if (strcmp(name, "philox") == 0)
+        *kind = RNG_PHILOX;
+    else if (strcmp(name, "libc") == 0)
+        *kind = RNG_LIBC;
+    else
+        return -1;
+    return 0;
+}
+
+int parse_reward_profile(const char *name, reward_profile_t *profile)
+{
+    if (strcmp(name, "uniform") == 0)
+        *profile = REWARD_UNIFORM;
+    else if (strcmp(name, "clustered") == 0)
+        *profile = REWARD_CLUSTERED;
+    else if (strcmp(name, "gradient") == 0)
+        *profile = REWARD_GRADIENT;
+    else
+        return -1;
+    return 0;
+}
+
+const char *rng_kind_name(rng_kind_t kind)
+{
+    return kind == RNG_LIBC ? "libc" : "philox";
+}
+
+const char *reward_profile_name(reward_profile_t profile)
+{
+    switch (profile)
+    {
+    case REWARD_CLUSTERED:
+        return "clustered";
+    case REWARD_GRADIENT:
+        return "gradient";
+    default:
+        return "uniform";
+    }
+}
+
+static int clamp_reward(int value)
+{
+    if (value < MIN_REWARD)
+        return MIN_REWARD;
+    if (value > MAX_REWARD)
+        return MAX_REWARD;
+    return value;
+}
+
+// Convierte un entero aleatorio de 32 bits en la recompensa de la celda (x, y)
+static int shape_reward(const gen_context_t *ctx, int x, int y, uint32_t r)
+{
+    int width = ctx->state->width;
+    int height = ctx->state->height;
+    int noise = (int)(r % NOISE_SPAN) - 1;
+
+    switch (ctx->gen->profile)
+    {
+    case REWARD_GRADIENT:
+    {
+        int span = width + height - 2;
+        int base = MIN_REWARD + ((x + y) * (MAX_REWARD - MIN_REWARD) + span / 2) / span;
+        return clamp_reward(base + noise);
+    }
+    case REWARD_CLUSTERED:
+    {
+        // Distancia de Chebyshev al centro más cercano
+        int nearest = INT_MAX;
+        for (int i = 0; i < ctx->cluster_count; i++)
+        {
+            int dx = abs(x - ctx->clusters[i].x);
+            int dy = abs(y - ctx->clusters[i].y);
+            int d = dx > dy ? dx : dy;
+            if (d < nearest)
+                nearest = d;
+        }
+        int base = MIN_REWARD;
+        if (nearest < ctx->cluster_radius)
+            base = MAX_REWARD - nearest * (MAX_REWARD - MIN_REWARD) / ctx->cluster_radius;
+        return clamp_reward(base + noise);
+    }
+    default:
+        // Multiplicación alta en vez de módulo: sin sesgo apreciable y sin división
+        return MIN_REWARD + (int)(((uint64_t)r * MAX_REWARD) >> 32);
+    }
+}
+
+static void fill_rows(const gen_context_t *ctx, int first_row, int last_row)
+{
+    int width = ctx->state->width;
+    uint32_t seed = ctx->gen->seed;
+
+    for (int y = first_row; y < last_row; y++)
+    {
+        uint32_t block[PHILOX_WORDS];
+
+        for (int x = 0; x < width; x++)
+        {
+            // Un bloque de Philox alcanza para 4 celdas consecutivas
+            if (x % PHILOX_WORDS == 0)
+            {
+                uint32_t counter[PHILOX_WORDS] = {(uint32_t)x / PHILOX_WORDS, (uint32_t)y, STREAM_BOARD, 0};
+                philox4x32(counter, seed, 0, block);
+            }
+            // escritura directa, la celda ya está en rango
+            ctx->state->board[BOARD_INDEX(width, x, y)] = shape_reward(ctx, x, y, block[x % PHILOX_WORDS]);
+        }
+    }
+}
+
+static void *fill_worker(void *arg)
+{
+    gen_task_t *task = arg;
+    fill_rows(task->ctx, task->first_row, task->last_row);
+    return NULL;
+}
+
+static void place_clusters(gen_context_t *ctx)
+{
+    int width = ctx->state->width;
+    int height = ctx->state->height;
+
+    ctx->cluster_count = (width * height) / CLUSTER_AREA;
+    if (ctx->cluster_count < 1)
+        ctx->cluster_count = 1;
+    if (ctx->cluster_count > MAX_CLUSTERS)
+        ctx->cluster_count = MAX_CLUSTERS;
+
+    ctx->cluster_radius = (width > height ? width : height) / (2 * ctx->cluster_count) + 2;
+
+    for (int i = 0; i < ctx->cluster_count; i++)
+    {
+        uint32_t counter[PHILOX_WORDS] = {(uint32_t)i, 0, STREAM_CLUSTERS, 0};
+        uint32_t out[PHILOX_WORDS];
+        philox4x32(counter, ctx->gen->seed, 0, out);
+        ctx->clusters[i].x = out[0] % width;
+        ctx->clusters[i].y = out[1] % height;
+    }
+}
+
+static int choose_thread_count(const board_gen_t *gen, int cells, int rows)
+{
+    int threads = gen->threads;
+    if (threads <= 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    // En tableros chicos crear hilos cuesta más que llenar el tablero
+    int useful = cells / GEN_MIN_CELLS_PER_THREAD;
+    if (useful < 1)
+        useful = 1;
+    if (threads > useful)
+        threads = useful;
+    if (threads > rows)
+        threads = rows;
+    if (threads > GEN_MAX_THREADS)
+        threads = GEN_MAX_THREADS;
+    return threads;
+}
+
+// Recorre tablero y asigna recompensas según el generador y el perfil configurados
+void initialize_board(game_state_t *state, const board_gen_t *gen)
+{
+    gen_context_t ctx = {.state = state, .gen = gen};
+    int width = state->width;
+    int height = state->height;
+
+    if (gen->profile == REWARD_CLUSTERED)
+        place_clusters(&ctx);
+
+    if (gen->rng == RNG_LIBC)
+    {
+        // Secuencial por definición: rand() tiene estado global
+        srand(gen->seed);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                int r = rand();
+                state->board[BOARD_INDEX(width, x, y)] = gen->profile == REWARD_UNIFORM
+                                                             ? MIN_REWARD + r % MAX_REWARD
+                                                             : shape_reward(&ctx, x, y, (uint32_t)r);
+            }
+        }
+        return;
+    }
+
+    int threads = choose_thread_count(gen, width * height, height);
+    if (threads <= 1)
+    {
+        fill_rows(&ctx, 0, height);
+        return;
+    }
+
+    pthread_t workers[GEN_MAX_THREADS];
+    bool started[GEN_MAX_THREADS];
+    gen_task_t tasks[GEN_MAX_THREADS];
+
+    for (int i = 0; i < threads; i++)
+    {
+        tasks[i].ctx = &ctx;
+        tasks[i].first_row = (int)((long)height * i / threads);
+        tasks[i].last_row = (int)((long)height * (i + 1) / threads);
+
+        // El último bloque (o uno cuyo hilo no se pudo crear) lo llena este hilo
+        started[i] = i < threads - 1 && pthread_create(&workers[i], NULL, fill_worker, &tasks[i]) == 0;
+        if (!started[i])
+            fill_rows(&ctx, tasks[i].first_row, tasks[i].last_row);
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        if (started[i])
+            pthread_join(workers[i], NULL);
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef BOARD_GEN_H
+#define BOARD_GEN_H
+
+#include "common.h"
+
+// Generador del tablero. RNG_PHILOX es contador-based (Philox4x32-10): el valor de
+// cada celda depende solo de (semilla, x, y), así que las filas se generan en paralelo
+// y el mismo seed produce el mismo tablero en cualquier máquina. RNG_LIBC reproduce
+// el tablero histórico con srand/rand.
+typedef enum
+{
+    RNG_PHILOX = 0,
+    RNG_LIBC
+} rng_kind_t;
+
+// Distribución de recompensas
+typedef enum
+{
+    REWARD_UNIFORM = 0, // Cada celda uniforme en [MIN_REWARD, MAX_REWARD]
+    REWARD_CLUSTERED,   // Zonas de recompensa alta alrededor de algunos centros
+    REWARD_GRADIENT     // Crece desde la esquina superior izquierda a la inferior derecha
+} reward_profile_t;
+
+typedef struct
+{
+    unsigned int seed;
+    rng_kind_t rng;
+    reward_profile_t profile;
+    int threads; // 0 = uno por CPU disponible
+} board_gen_t;
+
+#define PHILOX_WORDS 4
+#define GEN_MIN_CELLS_PER_THREAD (64 * 1024)
+#define GEN_MAX_THREADS 64
+
+void philox4x32(const uint32_t counter[PHILOX_WORDS], uint32_t key0, uint32_t key1, uint32_t out[PHILOX_WORDS]);
+int parse_rng_kind(const char *name, rng_kind_t *kind);
+int parse_reward_profile(const char *name, reward_profile_t *profile);
+const char *rng_kind_name(rng_kind_t kind);
+const char *reward_profile_name(reward_profile_t profile);
+
+void initialize_board(game_state_t *state, const board_gen_t *gen);
+
+#endif
@@ -0,0 +1,212 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "board_scan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_X86 1
+#else
+#define SCAN_X86 0
+#endif
+
+// Los acumuladores vectoriales son de 32 bits: se vuelcan a los de 64 cada tantos vectores
+// (MAX_REWARD por vuelta y por carril no llega a desbordar)
+#define SCAN_FLUSH_VECTORS (1u << 24)
+
+// Procesa un prefijo de cells (los vectores completos) y devuelve cuántas celdas cubrió;
+// board_scan termina la cola con scan_scalar
+typedef size_t (*scan_fn_t)(const int *cells, size_t count, unsigned int owners, board_summary_t *summary);
+
+typedef struct
+{
+    const char *name;
+    scan_fn_t scan;
+} scan_impl_t;
+
+static size_t scan_scalar(const int *cells, size_t count, unsigned int owners, board_summary_t *summary)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int value = cells[i];
+        if (value >= MIN_REWARD && value <= MAX_REWARD)
+        {
+            summary->free_cells++;
+            summary->reward += value;
+        }
+        else if (value <= 0 && (unsigned int)-value < owners)
+            summary->owned[-value]++;
+    }
+    return count;
+}
+
+#if SCAN_X86
+// Un kernel por ISA, con el mismo cuerpo. Por vector: libre = (v > MIN-1) & (MAX+1 > v), la
+// máscara (-1) se resta para contar y se usa de AND para sumar la recompensa; el histograma
+// es una comparación por jugador. La cola que no llena un vector queda para scan_scalar:
+// llamarla desde acá dejaba la transición AVX->SSE sin vzeroupper (GCC la convertía en un
+// salto de cola), y el siguiente código SSE del proceso (memcpy de glibc) la pagaba.
+#define DEFINE_SCAN_KERNEL(isa, TARGET, VEC, LANES, LOAD, SET1, ZERO, CMPGT, CMPEQ, AND, ADD, SUB, STORE)     \
+    __attribute__((target(TARGET))) static void flush_##isa(VEC acc, uint64_t *total)                          \
+    {                                                                                                          \
+        uint32_t lanes[LANES];                                                                                 \
+        STORE((VEC *)lanes, acc);                                                                              \
+        for (int l = 0; l < (LANES); l++)                                                                      \
+            *total += lanes[l];                                                                                \
+    }                                                                                                          \
+                                                                                                               \
+    __attribute__((target(TARGET))) static size_t scan_##isa(const int *cells, size_t count, unsigned int owners, \
+                                                             board_summary_t *summary)                           \
+    {                                                                                                          \
+        const VEC below = SET1(MIN_REWARD - 1);                                                                \
+        const VEC above = SET1(MAX_REWARD + 1);                                                                \
+        VEC owner_value[MAX_PLAYERS];                                                                          \
+        for (unsigned int p = 0; p < owners; p++)                                                              \
+            owner_value[p] = SET1(-(int)p);                                                                    \
+                                                                                                               \
+        size_t vectors = count / (LANES);                                                                      \
+        const int *cursor = cells;                                                                             \
+        while (vectors > 0)                                                                                    \
+        {                                                                                                      \
+            size_t batch = vectors < SCAN_FLUSH_VECTORS ? vectors : SCAN_FLUSH_VECTORS;                        \
+            VEC free_acc = ZERO(), reward_acc = ZERO();                                                        \
+            VEC owned_acc[MAX_PLAYERS];                                                                        \
+            for (unsigned int p = 0; p < owners; p++)                                                          \
+                owned_acc[p] = ZERO();                                                                         \
+                                                                                                               \
+            for (size_t v = 0; v < batch; v++, cursor += (LANES))                                              \
+            {                                                                                                  \
+                VEC value = LOAD((const VEC *)cursor);                                                         \
+                VEC is_free = AND(CMPGT(value, below), CMPGT(above, value));                                   \
+                free_acc = SUB(free_acc, is_free);                                                             \
+                reward_acc = ADD(reward_acc, AND(value, is_free));                                             \
+                for (unsigned int p = 0; p < owners; p++)                                                      \
+                    owned_acc[p] = SUB(owned_acc[p], CMPEQ(value, owner_value[p]));                            \
+            }                                                                                                  \
+                                                                                                               \
+            flush_##isa(free_acc, &summary->free_cells);                                                       \
+            flush_##isa(reward_acc, &summary->reward);                                                         \
+            for (unsigned int p = 0; p < owners; p++)                                                          \
+                flush_##isa(owned_acc[p], &summary->owned[p]);                                                 \
+            vectors -= batch;                                                                                  \
+        }                                                                                                      \
+        return (size_t)(cursor - cells);                                                                       \
+    }
+
+DEFINE_SCAN_KERNEL(avx2, "avx2", __m256i, 8, _mm256_loadu_si256, _mm256_set1_epi32, _mm256_setzero_si256,
+                   _mm256_cmpgt_epi32, _mm256_cmpeq_epi32, _mm256_and_si256, _mm256_add_epi32, _mm256_sub_epi32,
+                   _mm256_storeu_si256)
+DEFINE_SCAN_KERNEL(sse2, "sse2", __m128i, 4, _mm_loadu_si128, _mm_set1_epi32, _mm_setzero_si128, _mm_cmpgt_epi32,
+                   _mm_cmpeq_epi32, _mm_and_si128, _mm_add_epi32, _mm_sub_epi32, _mm_storeu_si128)
+#endif
+
+// De la más rápida a la más lenta
+static const scan_impl_t implementations[] = {
+#if SCAN_X86
+    {"avx2", scan_avx2},
+    {"sse2", scan_sse2},
+#endif
+    {"scalar", scan_scalar},
+};
+#define IMPLEMENTATION_COUNT (sizeof(implementations) / sizeof(implementations[0]))
+
+static const scan_impl_t *active_impl = NULL;
+
+// __builtin_cpu_supports solo acepta literales
+static bool cpu_supports(const scan_impl_t *impl)
+{
+#if SCAN_X86
+    __builtin_cpu_init();
+    if (strcmp(impl->name, "avx2") == 0)
+        return __builtin_cpu_supports("avx2");
+    if (strcmp(impl->name, "sse2") == 0)
+        return __builtin_cpu_supports("sse2");
+#endif
+    return true;
+}
+
+static const scan_impl_t *find_impl(const char *name)
+{
+    for (size_t i = 0; i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (strcmp(implementations[i].name, name) == 0)
+            return cpu_supports(&implementations[i]) ? &implementations[i] : NULL;
+    }
+    return NULL;
+}
+
+// La elección es idempotente: si dos hilos llegan juntos escriben el mismo puntero
+static const scan_impl_t *select_impl(void)
+{
+    const scan_impl_t *impl = __atomic_load_n(&active_impl, __ATOMIC_ACQUIRE);
+    if (impl)
+        return impl;
+
+    const char *forced = getenv(SCAN_ENV);
+    if (forced)
+        impl = find_impl(forced);
+    for (size_t i = 0; !impl && i < IMPLEMENTATION_COUNT; i++)
+    {
+        if (cpu_supports(&implementations[i]))
+            impl = &implementations[i];
+    }
+    __atomic_store_n(&active_impl, impl, __ATOMIC_RELEASE);
+    return impl;
+}
+
+void board_scan(const int *cells, size_t count, unsigned int owners, board_summary_t *summary)
+{
+    if (owners > MAX_PLAYERS)
+        owners = MAX_PLAYERS;
+    size_t done = select_impl()->scan(cells, count, owners, summary);
+    scan_scalar(cells + done, count - done, owners, summary);
+}
+
+void board_summarize(const game_state_t *state, board_summary_t *summary)
+{
+    int width = state->width;
+    int height = state->height;
+    unsigned int owners = state->player_count;
+    memset(summary, 0, sizeof(*summary));
+
+    if (BOARD_ROWMAJOR)
+    {
+        board_scan(state->board, (size_t)width * height, owners, summary);
+        return;
+    }
+
+    // Cada franja de teselas es contigua: las teselas completas van en una sola llamada y
+    // de la última (o de una franja incompleta) solo las filas y columnas dentro del tablero
+    int full_columns = width & ~BOARD_TILE_MASK;
+    for (int ty = 0; ty < height; ty += BOARD_TILE)
+    {
+        int rows = height - ty < BOARD_TILE ? height - ty : BOARD_TILE;
+        const int *band = &state->board[BOARD_INDEX(width, 0, ty)];
+        if (rows == BOARD_TILE)
+            board_scan(band, (size_t)full_columns * BOARD_TILE, owners, summary);
+        else
+        {
+            for (int tx = 0; tx < full_columns; tx += BOARD_TILE)
+                board_scan(band + (size_t)tx * BOARD_TILE, (size_t)rows * BOARD_TILE, owners, summary);
+        }
+        if (full_columns < width)
+        {
+            const int *tile = band + (size_t)full_columns * BOARD_TILE;
+            for (int r = 0; r < rows; r++)
+                board_scan(tile + r * BOARD_TILE, width - full_columns, owners, summary);
+        }
+    }
+}
+
+const char *board_scan_isa(void)
+{
+    return select_impl()->name;
+}
+
+int board_scan_use(const char *name)
+{
+    const scan_impl_t *impl = find_impl(name);
+    if (!impl)
+        return -1;
+    __atomic_store_n(&active_impl, impl, __ATOMIC_RELEASE);
+    return 0;
+}
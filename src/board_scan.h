@@ -0,0 +1,29 @@
+#ifndef BOARD_SCAN_H
+#define BOARD_SCAN_H
+
+#include "common.h"
+
+// Recorridos de tablero completo (celdas libres, recompensa restante y celdas de cada
+// jugador) en una sola pasada. Hay versiones AVX2, SSE2 y escalar; la primera llamada
+// elige la mejor que soporte la CPU (__builtin_cpu_supports).
+// CHOMP_SCAN=scalar|sse2|avx2 fuerza una (para comparar); si la CPU no la soporta se ignora.
+#define SCAN_ENV "CHOMP_SCAN"
+
+typedef struct
+{
+    uint64_t free_cells;         // Celdas con recompensa (MIN_REWARD..MAX_REWARD)
+    uint64_t reward;             // Suma de esas recompensas
+    uint64_t owned[MAX_PLAYERS]; // owned[i]: celdas con valor -i (cuerpo y cabeza del jugador i)
+} board_summary_t;
+
+// Acumula en summary las celdas [0, count) de cells; owned[] solo para los primeros owners
+// jugadores (owners = 0 se saltea el histograma, que es la parte cara)
+void board_scan(const int *cells, size_t count, unsigned int owners, board_summary_t *summary);
+// Resumen del tablero de state, sea cual sea el layout (con BOARD=tiled se saltea el relleno)
+void board_summarize(const game_state_t *state, board_summary_t *summary);
+// Nombre de la implementación en uso: "avx2", "sse2" o "scalar"
+const char *board_scan_isa(void);
+// Fuerza una implementación por nombre; -1 si no existe o la CPU no la soporta (scanbench)
+int board_scan_use(const char *name);
+
+#endif
@@ -0,0 +1,238 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "common.h"
+
+// Compara el tablero en orden de filas contra teselas de 8x8 (BOARD=tiled) en los accesos
+// que hace el juego: los 8 vecinos de una celda (player_has_valid_moves, check_game_end)
+// y un flood fill. Los dos layouts se instancian acá con BOARD_INDEX_ROWMAJOR/TILED, así que
+// no depende de con qué BOARD se compiló el resto. Mismo contenido en ambos: los checksums
+// tienen que coincidir.
+#define DEFAULT_BENCH_SIZE 2000
+#define DEFAULT_WALK_STEPS 20000000L
+#define DEFAULT_REPEATS 3
+#define BLOCKED_PER_MILLE 250 // Celdas ocupadas en el tablero de prueba (para el flood fill)
+#define PER_MILLE 1000
+
+typedef struct
+{
+    int width;
+    int height;
+    long steps;
+    int repeats;
+} bench_config_t;
+
+typedef struct
+{
+    const char *name;
+    double best_ms[2];
+    uint64_t checksum[2];
+} bench_result_t;
+
+static int offsets_x[DIRECTIONS_COUNT], offsets_y[DIRECTIONS_COUNT];
+
+void print_usage_boardbench(const char *program_name)
+{
+    printf("Usage: %s [-w width] [-h height] [-n walk_steps] [-r repeats]\n", program_name);
+    printf("  -w, -h : Board size (default: %dx%d)\n", DEFAULT_BENCH_SIZE, DEFAULT_BENCH_SIZE);
+    printf("  -n     : Steps of the neighbour-probe random walk (default: %ld)\n", DEFAULT_WALK_STEPS);
+    printf("  -r     : Repetitions, the best one is reported (default: %d)\n", DEFAULT_REPEATS);
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Kernels por layout. INDEX es una de las macros BOARD_INDEX_* de common.h.
+#define DEFINE_BOARD_KERNELS(layout, INDEX)                                                          \
+    static int free_neighbours_##layout(const int *cells, int w, int h, int x, int y)                \
+    {                                                                                                \
+        int count = 0;                                                                               \
+        for (int d = 0; d < DIRECTIONS_COUNT; d++)                                                   \
+        {                                                                                            \
+            int nx = x + offsets_x[d], ny = y + offsets_y[d];                                        \
+            if (nx >= 0 && nx < w && ny >= 0 && ny < h && cells[INDEX(w, nx, ny)] > 0)               \
+                count++;                                                                             \
+        }                                                                                            \
+        return count;                                                                                \
+    }                                                                                                \
+                                                                                                     \
+    /* Camino al azar como el de un jugador: en cada paso mira los 8 vecinos */                      \
+    static uint64_t walk_##layout(const int *cells, int w, int h, long steps)                        \
+    {                                                                                                \
+        uint64_t rng = 0x9E3779B97F4A7C15ULL, sum = 0;                                               \
+        int x = w / 2, y = h / 2;                                                                    \
+        for (long i = 0; i < steps; i++)                                                             \
+        {                                                                                            \
+            sum += free_neighbours_##layout(cells, w, h, x, y);                                      \
+            int d = next_random(&rng) % DIRECTIONS_COUNT;                                            \
+            int nx = x + offsets_x[d], ny = y + offsets_y[d];                                        \
+            if (nx >= 0 && nx < w && ny >= 0 && ny < h)                                              \
+            {                                                                                        \
+                x = nx;                                                                              \
+                y = ny;                                                                              \
+            }                                                                                        \
+        }                                                                                            \
+        return sum;                                                                                  \
+    }                                                                                                \
+                                                                                                     \
+    /* Barrido completo, como check_game_end con todos los jugadores */                              \
+    static uint64_t sweep_##layout(const int *cells, int w, int h)                                   \
+    {                                                                                                \
+        uint64_t sum = 0;                                                                            \
+        for (int y = 0; y < h; y++)                                                                  \
+            for (int x = 0; x < w; x++)                                                              \
+                sum += free_neighbours_##layout(cells, w, h, x, y);                                  \
+        return sum;                                                                                  \
+    }                                                                                                \
+                                                                                                     \
+    /* Flood fill 8-conexo de celdas libres desde el centro; visited en el mismo layout */           \
+    static uint64_t bfs_##layout(const int *cells, int w, int h, uint8_t *visited, uint32_t *queue)  \
+    {                                                                                                \
+        size_t head = 0, tail = 0;                                                                   \
+        uint64_t sum = 0;                                                                            \
+        int sx = w / 2, sy = h / 2;                                                                  \
+        visited[INDEX(w, sx, sy)] = 1;                                                               \
+        queue[tail++] = (uint32_t)sy << 16 | (uint32_t)sx;                                           \
+        while (head < tail)                                                                          \
+        {                                                                                            \
+            int x = queue[head] & 0xFFFF, y = queue[head] >> 16;                                     \
+            head++;                                                                                  \
+            sum += cells[INDEX(w, x, y)];                                                            \
+            for (int d = 0; d < DIRECTIONS_COUNT; d++)                                               \
+            {                                                                                        \
+                int nx = x + offsets_x[d], ny = y + offsets_y[d];                                    \
+                if (nx < 0 || nx >= w || ny < 0 || ny >= h)                                          \
+                    continue;                                                                        \
+                size_t i = INDEX(w, nx, ny);                                                         \
+                if (!visited[i] && cells[i] > 0)                                                     \
+                {                                                                                    \
+                    visited[i] = 1;                                                                  \
+                    queue[tail++] = (uint32_t)ny << 16 | (uint32_t)nx;                               \
+                }                                                                                    \
+            }                                                                                        \
+        }                                                                                            \
+        return sum + tail;                                                                           \
+    }
+
+DEFINE_BOARD_KERNELS(rowmajor, BOARD_INDEX_ROWMAJOR)
+DEFINE_BOARD_KERNELS(tiled, BOARD_INDEX_TILED)
+
+// Mismo contenido en los dos layouts: recompensas y ~25% de celdas ocupadas
+static void fill_boards(int *rowmajor, int *tiled, int w, int h)
+{
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            uint64_t r = next_random(&rng);
+            int value = (int)(r % PER_MILLE) < BLOCKED_PER_MILLE ? -(int)(r % MAX_PLAYERS)
+                                                                 : MIN_REWARD + (int)((r >> 32) % MAX_REWARD);
+            rowmajor[BOARD_INDEX_ROWMAJOR(w, x, y)] = value;
+            tiled[BOARD_INDEX_TILED(w, x, y)] = value;
+        }
+    }
+}
+
+static void record(bench_result_t *result, int layout, uint64_t start, uint64_t checksum)
+{
+    double ms = (double)(monotonic_ns() - start) / NS_PER_MS;
+    if (result->best_ms[layout] == 0 || ms < result->best_ms[layout])
+        result->best_ms[layout] = ms;
+    result->checksum[layout] = checksum;
+}
+
+int main(int argc, char *argv[])
+{
+    bench_config_t config = {DEFAULT_BENCH_SIZE, DEFAULT_BENCH_SIZE, DEFAULT_WALK_STEPS, DEFAULT_REPEATS};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:n:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w':
+            config.width = atoi(optarg);
+            break;
+        case 'h':
+            config.height = atoi(optarg);
+            break;
+        case 'n':
+            config.steps = atol(optarg);
+            break;
+        case 'r':
+            config.repeats = atoi(optarg);
+            break;
+        default:
+            print_usage_boardbench(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    // Las coordenadas del flood fill van empaquetadas en 16 bits cada una
+    if (config.width < MIN_BOARD_SIZE || config.height < MIN_BOARD_SIZE || config.width > UINT16_MAX ||
+        config.height > UINT16_MAX || config.steps < 1 || config.repeats < 1)
+    {
+        print_usage_boardbench(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int d = 0; d < DIRECTIONS_COUNT; d++)
+        get_direction_offset(d, &offsets_x[d], &offsets_y[d]);
+
+    int w = config.width, h = config.height;
+    size_t rowmajor_cells = (size_t)w * h;
+    size_t tiled_cells = (size_t)BOARD_PAD(w) * BOARD_PAD(h);
+    int *rowmajor = malloc(rowmajor_cells * sizeof(int));
+    int *tiled = calloc(tiled_cells, sizeof(int));
+    uint8_t *visited = malloc(tiled_cells);
+    uint32_t *queue = malloc(rowmajor_cells * sizeof(uint32_t));
+    if (!rowmajor || !tiled || !visited || !queue)
+        error_exit("malloc boards");
+    fill_boards(rowmajor, tiled, w, h);
+
+    bench_result_t results[] = {{.name = "walk"}, {.name = "sweep"}, {.name = "bfs"}};
+    for (int r = 0; r < config.repeats; r++)
+    {
+        uint64_t start = monotonic_ns();
+        record(&results[0], 0, start, walk_rowmajor(rowmajor, w, h, config.steps));
+        start = monotonic_ns();
+        record(&results[0], 1, start, walk_tiled(tiled, w, h, config.steps));
+
+        start = monotonic_ns();
+        record(&results[1], 0, start, sweep_rowmajor(rowmajor, w, h));
+        start = monotonic_ns();
+        record(&results[1], 1, start, sweep_tiled(tiled, w, h));
+
+        memset(visited, 0, rowmajor_cells);
+        start = monotonic_ns();
+        record(&results[2], 0, start, bfs_rowmajor(rowmajor, w, h, visited, queue));
+        memset(visited, 0, tiled_cells);
+        start = monotonic_ns();
+        record(&results[2], 1, start, bfs_tiled(tiled, w, h, visited, queue));
+    }
+
+    printf("board %dx%d, tiles %dx%d, walk %ld steps, best of %d\n", w, h, BOARD_TILE, BOARD_TILE, config.steps,
+           config.repeats);
+    printf("%-8s %12s %12s %8s %s\n", "bench", "rowmajor_ms", "tiled_ms", "speedup", "checksum");
+    int status = EXIT_SUCCESS;
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++)
+    {
+        bench_result_t *res = &results[i];
+        bool match = res->checksum[0] == res->checksum[1];
+        printf("%-8s %12.2f %12.2f %7.2fx %016lx%s\n", res->name, res->best_ms[0], res->best_ms[1],
+               res->best_ms[1] > 0 ? res->best_ms[0] / res->best_ms[1] : 0.0, (unsigned long)res->checksum[0],
+               match ? "" : " MISMATCH");
+        if (!match)
+            status = EXIT_FAILURE;
+    }
+
+    free(rowmajor);
+    free(tiled);
+    free(visited);
+    free(queue);
+    return status;
+}
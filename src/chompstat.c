@@ -0,0 +1,168 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "stats.h"
+#include "scheduler.h"
+
+#define PERCENT 100.0
+#define P50 0.50
+#define P99 0.99
+#define NS_PER_US 1000.0
+
+// Monitor del segmento de estadísticas: solo lee, nunca toma semáforos del juego
+static game_stats_t *game_stats = NULL;
+
+// Copia de los contadores globales para calcular diferencias entre muestras
+typedef struct
+{
+    uint64_t now;
+    uint64_t moves;
+    uint64_t invalid;
+    uint64_t select_ns;
+    uint64_t idle_ns;
+    uint64_t state_wait_ns;
+    uint64_t state_hold_ns;
+    uint64_t notify_ns;
+    uint64_t sleep_ns;
+} sample_t;
+
+void signal_handler(int sig)
+{
+    (void)sig;
+    stats_close(game_stats);
+    exit(EXIT_SUCCESS);
+}
+
+void take_sample(sample_t *sample)
+{
+    sample->now = monotonic_ns();
+    sample->moves = STATS_LOAD(game_stats, moves_processed);
+    sample->invalid = STATS_LOAD(game_stats, invalid_moves);
+    sample->select_ns = STATS_LOAD(game_stats, select_ns);
+    sample->idle_ns = STATS_LOAD(game_stats, idle_ns);
+    sample->state_wait_ns = STATS_LOAD(game_stats, state_wait_ns);
+    sample->state_hold_ns = STATS_LOAD(game_stats, state_hold_ns);
+    sample->notify_ns = STATS_LOAD(game_stats, notify_view_ns);
+    sample->sleep_ns = STATS_LOAD(game_stats, sleep_ns);
+}
+
+double share(uint64_t part, uint64_t total)
+{
+    return total ? PERCENT * part / total : 0.0;
+}
+
+void print_sample(const sample_t *prev, const sample_t *cur)
+{
+    uint64_t elapsed = cur->now - prev->now;
+    uint64_t moves = cur->moves - prev->moves;
+    uint64_t invalid = cur->invalid - prev->invalid;
+
+    printf("%8.1fs moves/s=%-8.0f invalid=%5.1f%% select=%5.1f%% idle=%5.1f%% mutex_wait=%5.1f%% "
+           "mutex_hold=%5.1f%% view=%5.1f%% sleep=%5.1f%%\n",
+           (double)(cur->now - STATS_LOAD(game_stats, start_ns)) / NS_PER_SECOND,
+           elapsed ? (double)moves * NS_PER_SECOND / elapsed : 0.0,
+           share(invalid, moves),
+           share(cur->select_ns - prev->select_ns, elapsed),
+           share(cur->idle_ns - prev->idle_ns, elapsed),
+           share(cur->state_wait_ns - prev->state_wait_ns, elapsed),
+           share(cur->state_hold_ns - prev->state_hold_ns, elapsed),
+           share(cur->notify_ns - prev->notify_ns, elapsed),
+           share(cur->sleep_ns - prev->sleep_ns, elapsed));
+
+    unsigned int player_count = STATS_LOAD(game_stats, player_count);
+    for (unsigned int i = 0; i < player_count && i < MAX_PLAYERS; i++)
+    {
+        uint64_t count = STATS_LOAD(game_stats, latency_count[i]);
+        uint64_t sum = STATS_LOAD(game_stats, latency_sum_ns[i]);
+        uint64_t served = STATS_LOAD(game_stats, sched_served[i]);
+        uint64_t queued = STATS_LOAD(game_stats, sched_wait_sum_ns[i]);
+        printf("          P%u decisions=%-8lu avg=%9.1fus p50<%9.1fus p99<%9.1fus queue avg=%8.1fus max=%8.1fus "
+               "bypass<=%lu\n",
+               i, (unsigned long)count, count ? sum / NS_PER_US / count : 0.0,
+               stats_latency_percentile(game_stats, i, P50) / NS_PER_US,
+               stats_latency_percentile(game_stats, i, P99) / NS_PER_US, served ? queued / NS_PER_US / served : 0.0,
+               STATS_LOAD(game_stats, sched_wait_max_ns[i]) / NS_PER_US,
+               (unsigned long)STATS_LOAD(game_stats, sched_max_bypass[i]));
+    }
+    fflush(stdout);
+}
+
+// Métricas de arranque del máster, se muestran una sola vez
+void print_startup(void)
+{
+    printf("startup: sched=%s spawned=%.3fms board_ready=%.3fms first_move=%.3fms\n",
+           scheduler_policy_name((scheduler_policy_t)STATS_LOAD(game_stats, sched_policy)),
+           (double)STATS_LOAD(game_stats, spawn_ns) / NS_PER_MS,
+           (double)STATS_LOAD(game_stats, setup_ns) / NS_PER_MS,
+           (double)STATS_LOAD(game_stats, first_move_ns) / NS_PER_MS);
+}
+
+int main(int argc, char *argv[])
+{
+    int interval_ms = DEFAULT_STATS_INTERVAL;
+    long samples = -1;
+    pid_t master_pid = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "N:p:i:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'N':
+            if (!valid_shm_namespace(optarg) || setenv(SHM_NAMESPACE_ENV, optarg, 1) == -1)
+            {
+                fprintf(stderr, "Invalid namespace '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'p':
+            master_pid = (pid_t)atoi(optarg);
+            break;
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 'n':
+            samples = atol(optarg);
+            break;
+        default:
+            print_usage_chompstat(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (interval_ms <= 0)
+    {
+        print_usage_chompstat(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    game_stats = stats_open_readonly(master_pid);
+    if (!game_stats)
+        error_exit("stats_open_readonly");
+
+    sample_t prev, cur;
+    take_sample(&prev);
+    bool startup_printed = false;
+
+    while (samples != 0)
+    {
+        usleep(interval_ms * US_TO_MS);
+        take_sample(&cur);
+        if (!startup_printed && STATS_LOAD(game_stats, first_move_ns))
+        {
+            print_startup();
+            startup_printed = true;
+        }
+        print_sample(&prev, &cur);
+        prev = cur;
+
+        if (samples > 0)
+            samples--;
+        if (STATS_LOAD(game_stats, game_finished))
+            break;
+    }
+
+    stats_close(game_stats);
+    return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include <stdbool.h>
 #include <sys/select.h>
 #include <dirent.h>
+#include <spawn.h>
 
 #define MAX_PLAYERS 9
 #define MIN_BOARD_SIZE 10
@@ -43,6 +44,9 @@
 #define INVALID_FD -1
 #define SEM_INIT_ZERO 0
 #define SEM_INIT_ONE 1
+#define NS_PER_SECOND 1000000000ULL
+#define NS_PER_MS 1000000ULL
+#define DEFAULT_STATS_INTERVAL 1000
 
 // Parámetros de visualización de barras de score
 #define SCORE_BAR_UNIT_STATE 20
@@ -63,6 +67,27 @@
 // Nombres de memorias compartidas
 #define GAME_STATE_SHM "/game_state"
 #define GAME_SYNC_SHM "/game_sync"
+#define GAME_INDEX_SHM "/game_index" // Índice de recompensa restante (reward_index.h)
+// Si está definida, los nombres pasan a ser "/<ns>.game_state", etc. El máster la
+// exporta (--ns) y la vista y los jugadores la heredan al hacer exec.
+#define SHM_NAMESPACE_ENV "CHOMP_SHM_NS"
+#define SHM_NAME_SIZE 128
+// Modo memfd: los segmentos no tienen nombre y los hijos reciben el descriptor por entorno
+#define SHM_STATE_FD_ENV "CHOMP_STATE_FD"
+#define SHM_SYNC_FD_ENV "CHOMP_SYNC_FD"
+#define SHM_INDEX_FD_ENV "CHOMP_INDEX_FD"
+// Id que el máster le asigna a cada jugador al lanzarlo (evita buscar el pid con el lock tomado)
+#define PLAYER_ID_ENV "CHOMP_PLAYER_ID"
+
+// Flags de create_shared_memory
+#define SHM_FLAG_MEMFD 0x1
+// Ajustes del mapeo del estado (el segmento grande). El máster los exporta en
+// CHOMP_SHM_FLAGS y la vista y los jugadores los aplican a su propio mapeo.
+#define SHM_FLAG_HUGEPAGES 0x2 // madvise(MADV_HUGEPAGE): THP de shmem si el kernel lo permite
+#define SHM_FLAG_PREFAULT 0x4  // Páginas cargadas al mapear, sin fallos en el primer recorrido
+#define SHM_FLAG_MLOCK 0x8     // mlock: una partida en curso nunca espera por paginado
+#define SHM_MAPPING_FLAGS (SHM_FLAG_HUGEPAGES | SHM_FLAG_PREFAULT | SHM_FLAG_MLOCK)
+#define SHM_FLAGS_ENV "CHOMP_SHM_FLAGS"
 
 // Estructura del jugador
 typedef struct
@@ -76,6 +101,116 @@ typedef struct
     bool blocked;                // Indica si el jugador está bloqueado
 } player_t;
 
+#define CACHE_LINE_SIZE 64
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))
+
+// Semáforo contador sobre un futex con espera activa acotada (turnsync.c). Cada uno en
+// su propia línea de caché: el que espera gira leyendo value.
+typedef struct
+{
+    uint32_t value;   // Permisos disponibles
+    uint32_t waiters; // Procesos dormidos (o por dormir) en FUTEX_WAIT
+    uint32_t spin;    // Vueltas de espera activa antes de dormir; se adapta en cada espera
+} CACHE_ALIGNED futex_sem_t;
+
+// Mecanismo de los traspasos de turno (player_can_move, view_notify y view_done)
+#define TURN_MODE_SEM 0   // Semáforos POSIX, como el binario de la cátedra
+#define TURN_MODE_FUTEX 1 // futex_sem_t (master --futex)
+#define TURN_SLOT_VIEW_NOTIFY MAX_PLAYERS
+#define TURN_SLOT_VIEW_DONE (MAX_PLAYERS + 1)
+#define TURN_SLOTS (MAX_PLAYERS + 2)
+
+// Orden de las celdas en game_state_t.board. Por defecto filas (y * width + x), como el
+// binario de la cátedra. Con make BOARD=tiled el tablero se guarda en teselas de 8x8
+// consecutivas: los 8 vecinos de una celda caen casi siempre en la misma tesela (256
+// bytes, 4 líneas de caché) en vez de en tres filas distintas. El ancho y el alto se
+// rellenan hasta múltiplo de 8; las celdas de relleno nunca se leen.
+// Los mapas guardan el tablero en orden de filas; el protocolo del proxy usa el layout
+// compilado (proxy y motor se compilan juntos).
+#define BOARD_TILE_SHIFT 3
+#define BOARD_TILE (1 << BOARD_TILE_SHIFT)
+#define BOARD_TILE_MASK (BOARD_TILE - 1)
+#define BOARD_PAD(n) (((n) + BOARD_TILE_MASK) & ~BOARD_TILE_MASK)
+#define BOARD_INDEX_ROWMAJOR(width, x, y) ((y) * (width) + (x))
+#define BOARD_INDEX_TILED(width, x, y)                                                              \
+    (((((y) >> BOARD_TILE_SHIFT) * BOARD_PAD(width) + ((x) & ~BOARD_TILE_MASK)) << BOARD_TILE_SHIFT) + \
+     (((y) & BOARD_TILE_MASK) << BOARD_TILE_SHIFT) + ((x) & BOARD_TILE_MASK))
+
+#ifdef CHOMP_TILED_BOARD
+#define BOARD_ROWMAJOR 0
+#define BOARD_INDEX(width, x, y) BOARD_INDEX_TILED(width, x, y)
+#define BOARD_CELLS(width, height) ((size_t)BOARD_PAD(width) * BOARD_PAD(height))
+#else
+#define BOARD_ROWMAJOR 1
+#define BOARD_INDEX(width, x, y) BOARD_INDEX_ROWMAJOR(width, x, y)
+#define BOARD_CELLS(width, height) ((size_t)(width) * (height))
+#endif
+
+#ifdef CHOMP_SPLIT_LAYOUT
+// Layout hot/cold (make LAYOUT=split): las posiciones y el flag de bloqueo, que se
+// recorren en cada iteración del master y de la vista, quedan juntos en la primera
+// línea de caché; nombres y contadores van aparte. No es compatible con el binario
+// ChompChamps de la cátedra, por eso no es el layout por defecto.
+typedef struct
+{
+    unsigned short x, y; // Coordenadas x e y en el tablero
+} player_pos_t;
+
+typedef struct
+{
+    unsigned int score;         // Puntaje
+    unsigned int invalid_moves; // Cantidad de movimientos inválidos
+    unsigned int valid_moves;   // Cantidad de movimientos válidos
+    pid_t pid;                  // Identificador de proceso
+} player_stats_t;
+
+// Estructura del estado del juego
+typedef struct
+{
+    unsigned short width;                        // Ancho del tablero
+    unsigned short height;                       // Alto del tablero
+    unsigned int player_count;                   // Cantidad de jugadores
+    player_pos_t pos[MAX_PLAYERS];               // Posiciones (hot)
+    bool blocked[MAX_PLAYERS];                   // Jugadores bloqueados (hot)
+    bool game_finished;                          // Indica si el juego se ha terminado
+    player_stats_t stats[MAX_PLAYERS];           // Puntajes y contadores (cold)
+    char names[MAX_PLAYERS][PLAYER_NAME_SIZE];   // Nombres (cold)
+    int board[];                                 // Tablero (flexible array member)
+} game_state_t;
+
+#define PLAYER_X(state, i) ((state)->pos[i].x)
+#define PLAYER_Y(state, i) ((state)->pos[i].y)
+#define PLAYER_BLOCKED(state, i) ((state)->blocked[i])
+#define PLAYER_SCORE(state, i) ((state)->stats[i].score)
+#define PLAYER_VALID_MOVES(state, i) ((state)->stats[i].valid_moves)
+#define PLAYER_INVALID_MOVES(state, i) ((state)->stats[i].invalid_moves)
+#define PLAYER_PID(state, i) ((state)->stats[i].pid)
+#define PLAYER_NAME(state, i) ((state)->names[i])
+
+// Semáforo en su propia línea de caché para evitar false sharing
+typedef struct
+{
+    sem_t sem;
+} CACHE_ALIGNED padded_sem_t;
+
+// Estructura de sincronización
+typedef struct
+{
+    sem_t view_notify;                          // A: El máster le indica a la vista que hay cambios
+    sem_t view_done;                            // B: La vista le indica al máster que terminó
+    sem_t master_access CACHE_ALIGNED;          // C: Mutex para evitar inanición del máster
+    sem_t state_mutex;                          // D: Mutex para el estado del juego
+    sem_t reader_count_mutex CACHE_ALIGNED;     // E: Mutex para la variable de lectores
+    unsigned int reader_count;                  // F: Cantidad de jugadores leyendo el estado
+    padded_sem_t player_can_move[MAX_PLAYERS];  // G: Indica a cada jugador que puede enviar movimiento
+    uint32_t turn_mode CACHE_ALIGNED;           // H: TURN_MODE_* elegido por el máster
+    uint32_t turn_spin_max;                     // I: Tope de espera activa (0 con una sola CPU)
+    futex_sem_t turn_futex[TURN_SLOTS];         // J: Turnos y vista cuando turn_mode es futex
+} game_sync_t;
+
+#define PLAYER_CAN_MOVE(sync, i) (&(sync)->player_can_move[i].sem)
+
+#else
 // Estructura del estado del juego
 typedef struct
 {
@@ -87,6 +222,15 @@ typedef struct
     int board[];                   // Tablero (flexible array member)
 } game_state_t;
 
+#define PLAYER_X(state, i) ((state)->players[i].x)
+#define PLAYER_Y(state, i) ((state)->players[i].y)
+#define PLAYER_BLOCKED(state, i) ((state)->players[i].blocked)
+#define PLAYER_SCORE(state, i) ((state)->players[i].score)
+#define PLAYER_VALID_MOVES(state, i) ((state)->players[i].valid_moves)
+#define PLAYER_INVALID_MOVES(state, i) ((state)->players[i].invalid_moves)
+#define PLAYER_PID(state, i) ((state)->players[i].pid)
+#define PLAYER_NAME(state, i) ((state)->players[i].name)
+
 // Estructura de sincronización
 typedef struct
 {
@@ -97,10 +241,23 @@ typedef struct
     sem_t reader_count_mutex;           // E: Mutex para la variable de lectores
     unsigned int reader_count;          // F: Cantidad de jugadores leyendo el estado
     sem_t player_can_move[MAX_PLAYERS]; // G: Indica a cada jugador que puede enviar movimiento
+    // Agregado al final: hasta G el layout es el de la cátedra. Contra su máster el segmento
+    // es más chico, pero todo entra en la misma página y lo que sigue a G se lee en cero
+    // (TURN_MODE_SEM).
+    uint32_t turn_mode CACHE_ALIGNED;   // H: TURN_MODE_* elegido por el máster
+    uint32_t turn_spin_max;             // I: Tope de espera activa (0 con una sola CPU)
+    futex_sem_t turn_futex[TURN_SLOTS]; // J: Turnos y vista cuando turn_mode es futex
 } game_sync_t;
 
+_Static_assert(sizeof(game_sync_t) <= 4096, "game_sync_t debe entrar en una página");
+
+#define PLAYER_CAN_MOVE(sync, i) (&(sync)->player_can_move[i])
+#endif
+
 // Funciones auxiliares
 void error_exit(const char *msg);
+int write_all(int fd, const void *data, size_t size);
+uint64_t monotonic_ns(void);
 void cleanup_resources(void);
 int get_board_cell(game_state_t *state, int x, int y);
 void set_board_cell(game_state_t *state, int x, int y, int value);
@@ -108,18 +265,39 @@ bool is_valid_position(game_state_t *state, int x, int y);
 bool is_cell_free(game_state_t *state, int x, int y);
 void get_direction_offset(unsigned char direction, int *dx, int *dy);
 bool player_has_valid_moves(game_state_t *state, unsigned int player_id);
+void get_player(game_state_t *state, unsigned int player_id, player_t *out);
+int player_id_from_env(const game_state_t *state);
 void print_usage_master(const char *program_name);
 void print_usage_view(const char *program_name);
 void print_usage_player(const char *program_name);
-
-// Funciones específicas del player
-unsigned char choose_move_with_local_data(player_t *my_player, int *local_board, int board_width, int board_height);
+void print_usage_replay(const char *program_name);
+void print_usage_chompstat(const char *program_name);
 
 // Funciones genéricas para memoria compartida
 void cleanup_shared_memory(game_state_t *game_state, game_sync_t *game_sync);
 int connect_shared_memory(int width, int height, game_state_t **game_state, game_sync_t **game_sync);
+void read_lock_state(game_sync_t *game_sync);
+void read_unlock_state(game_sync_t *game_sync);
+int create_shared_memory(int width, int height, unsigned int player_count, int flags, game_state_t **game_state, game_sync_t **game_sync);
+void close_inherited_segments(void);
+void unlink_shared_memory(void);
+int create_segment(const char *base, const char *memfd_name, size_t size, int flags);
+int tune_state_mapping(void *addr, size_t size, int flags, bool writable);
+int seal_segment(int fd, bool read_only);
+int export_segment_fd(const char *env_name, int fd);
+int open_segment(const char *base, const char *fd_env, int oflag);
+int shm_object_name(const char *base, char *out, size_t size);
+int shm_open_ns(const char *base, int flags, mode_t mode);
+int shm_unlink_ns(const char *base);
+bool valid_shm_namespace(const char *ns);
 
 // Funciones para lógica del juego
 int find_winner(game_state_t *state);
+void place_players(game_state_t *state);
+bool process_move(game_state_t *state, int player_id, unsigned char direction);
+// Conversión entre el layout del tablero y orden de filas (un memcpy salvo con BOARD=tiled)
+void board_to_rowmajor(const game_state_t *state, int *out);
+void board_from_rowmajor(game_state_t *state, const int *in);
+bool check_game_end(game_state_t *state);
 
 #endif
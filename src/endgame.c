@@ -0,0 +1,536 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "endgame.h"
+
+#define NO_CELL (-1)
+#define EXACT_SLOT_BITS 4 // memo[(visitadas << 4) | celda]: alcanza para ENDGAME_EXACT_CELLS = 16
+#define BITS_PER_WORD 64
+#define SYMMETRIES 8     // 4 rotaciones, con y sin espejo
+#define SYMMETRY_FLIP 4  // Bit de espejo; los dos de abajo son cuartos de vuelta horarios
+#define KEY_SEED_HI 0x9E3779B97F4A7C15ULL
+#define KEY_SEED_LO 0xC2B2AE3D27D4EB4FULL
+
+_Static_assert(ENDGAME_EXACT_CELLS <= (1 << EXACT_SLOT_BITS), "memo exacta: celda en EXACT_SLOT_BITS");
+_Static_assert(ENDGAME_MAX_CELLS <= SHRT_MAX, "los índices de la bolsa entran en short");
+
+// Vecinos de la cabeza dentro de la bolsa: el punto de partida de las dos búsquedas
+typedef struct
+{
+    short slot[DIRECTIONS_COUNT];
+} start_t;
+
+typedef struct
+{
+    int parent;        // Estado del nivel anterior
+    short cell;        // Celda a la que se mueve
+    unsigned char dir; // Movimiento desde la celda del padre
+    int score;
+    long key;          // Orden en el beam (mayor primero)
+} beam_candidate_t;
+
+typedef struct
+{
+    short parent;
+    unsigned char dir;
+} beam_step_t;
+
+static bool is_free(int value)
+{
+    return value >= MIN_REWARD && value <= MAX_REWARD;
+}
+
+void endgame_init(endgame_t *endgame, uint64_t time_limit_ns)
+{
+    memset(endgame, 0, sizeof(*endgame));
+    endgame->time_limit_ns = time_limit_ns;
+}
+
+void endgame_destroy(endgame_t *endgame)
+{
+    free(endgame->mark);
+    free(endgame->mark_slot);
+    endgame->mark = NULL;
+    endgame->mark_slot = NULL;
+    endgame->mark_size = 0;
+}
+
+long endgame_limit_from_env(void)
+{
+    const char *value = getenv(ENDGAME_ENV);
+    if (!value || !*value)
+        return ENDGAME_DEFAULT_LIMIT_MS;
+    if (strcmp(value, "off") == 0)
+        return -1;
+    char *end;
+    long ms = strtol(value, &end, 10);
+    return *end == '\0' && ms >= 0 ? ms : ENDGAME_DEFAULT_LIMIT_MS;
+}
+
+static bool prepare_marks(endgame_t *endgame, size_t cells)
+{
+    if (endgame->mark_size < cells)
+    {
+        uint32_t *mark = calloc(cells, sizeof(uint32_t));
+        short *slot = malloc(cells * sizeof(short));
+        if (!mark || !slot)
+        {
+            free(mark);
+            free(slot);
+            return false;
+        }
+        endgame_destroy(endgame);
+        endgame->mark = mark;
+        endgame->mark_slot = slot;
+        endgame->mark_size = cells;
+        endgame->stamp = 0;
+    }
+    if (++endgame->stamp == 0) // Dio la vuelta: las marcas viejas podrían coincidir
+    {
+        memset(endgame->mark, 0, endgame->mark_size * sizeof(uint32_t));
+        endgame->stamp = 1;
+    }
+    return true;
+}
+
+// Celda libre no marcada: la agrega a la bolsa. false si la bolsa ya está llena
+static bool visit(endgame_t *endgame, const board_view_t *board, int x, int y)
+{
+    if (x < 0 || x >= board->width || y < 0 || y >= board->height)
+        return true;
+    size_t at = (size_t)y * board->width + x;
+    if (endgame->mark[at] == endgame->stamp || !is_free(board->cells[BOARD_INDEX(board->width, x, y)]))
+        return true;
+    if (endgame->cells == ENDGAME_MAX_CELLS)
+        return false;
+
+    unsigned int slot = endgame->cells++;
+    endgame->mark[at] = endgame->stamp;
+    endgame->mark_slot[at] = (short)slot;
+    endgame->cell_x[slot] = (unsigned short)x;
+    endgame->cell_y[slot] = (unsigned short)y;
+    endgame->reward[slot] = (unsigned char)board->cells[BOARD_INDEX(board->width, x, y)];
+    return true;
+}
+
+static short slot_at(const endgame_t *endgame, const board_view_t *board, int x, int y)
+{
+    if (x < 0 || x >= board->width || y < 0 || y >= board->height)
+        return NO_CELL;
+    size_t at = (size_t)y * board->width + x;
+    return endgame->mark[at] == endgame->stamp ? endgame->mark_slot[at] : NO_CELL;
+}
+
+// Flood fill (8 vecinos) desde la cabeza. Se corta en cuanto la bolsa toca la cabeza de un
+// rival que todavía puede moverse o supera ENDGAME_MAX_CELLS. Con la bolsa completa arma
+// la tabla de vecinos y los vecinos de la cabeza (start).
+static bool find_isolated_region(endgame_t *endgame, const board_view_t *board, unsigned int me_id,
+                                 const player_t *players, start_t *start)
+{
+    endgame->cells = 0;
+    if (!prepare_marks(endgame, (size_t)board->width * board->height))
+        return false;
+
+    int rival_x[MAX_PLAYERS], rival_y[MAX_PLAYERS];
+    unsigned int rivals = 0;
+    for (unsigned int i = 0; i < board->player_count && i < MAX_PLAYERS; i++)
+    {
+        if (i == me_id || players[i].blocked)
+            continue;
+        rival_x[rivals] = players[i].x;
+        rival_y[rivals] = players[i].y;
+        rivals++;
+    }
+
+    const player_t *me = &players[me_id];
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int dx, dy;
+        get_direction_offset(dir, &dx, &dy);
+        if (!visit(endgame, board, me->x + dx, me->y + dy))
+            return false;
+    }
+
+    // La bolsa hace de cola del BFS
+    for (unsigned int head = 0; head < endgame->cells; head++)
+    {
+        int x = endgame->cell_x[head], y = endgame->cell_y[head];
+        for (unsigned int r = 0; r < rivals; r++)
+        {
+            if (abs(rival_x[r] - x) <= 1 && abs(rival_y[r] - y) <= 1)
+                return false;
+        }
+        for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+        {
+            int dx, dy;
+            get_direction_offset(dir, &dx, &dy);
+            if (!visit(endgame, board, x + dx, y + dy))
+                return false;
+        }
+    }
+    if (endgame->cells == 0)
+        return false;
+
+    for (unsigned int i = 0; i < endgame->cells; i++)
+    {
+        for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+        {
+            int dx, dy;
+            get_direction_offset(dir, &dx, &dy);
+            endgame->neighbour[i][dir] = slot_at(endgame, board, endgame->cell_x[i] + dx, endgame->cell_y[i] + dy);
+        }
+    }
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int dx, dy;
+        get_direction_offset(dir, &dx, &dy);
+        start->slot[dir] = slot_at(endgame, board, me->x + dx, me->y + dy);
+    }
+    return true;
+}
+
+// Mejor recompensa que se puede juntar desde cell habiendo visitado mask (que incluye cell)
+static int exact_best(const endgame_t *endgame, int16_t *memo, unsigned int cell, uint32_t mask)
+{
+    int16_t *entry = &memo[((size_t)mask << EXACT_SLOT_BITS) | cell];
+    if (*entry >= 0)
+        return *entry;
+
+    int best = 0;
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int next = endgame->neighbour[cell][dir];
+        if (next == NO_CELL || (mask & (1u << next)))
+            continue;
+        int value = endgame->reward[next] + exact_best(endgame, memo, next, mask | (1u << next));
+        if (value > best)
+            best = value;
+    }
+    *entry = (int16_t)best;
+    return best;
+}
+
+static bool plan_exact(endgame_t *endgame, const start_t *start)
+{
+    size_t entries = (size_t)1 << (endgame->cells + EXACT_SLOT_BITS);
+    int16_t *memo = malloc(entries * sizeof(int16_t));
+    if (!memo)
+        return false;
+    memset(memo, 0xFF, entries * sizeof(int16_t)); // -1: sin calcular
+
+    // Se reconstruye el camino siguiendo en cada paso al vecino que realiza el óptimo
+    const short *options = start->slot;
+    uint32_t mask = 0;
+    int total = 0;
+    for (;;)
+    {
+        int best = -1;
+        unsigned char best_dir = 0;
+        for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+        {
+            int next = options[dir];
+            if (next == NO_CELL || (mask & (1u << next)))
+                continue;
+            int value = endgame->reward[next] + exact_best(endgame, memo, next, mask | (1u << next));
+            if (value > best)
+            {
+                best = value;
+                best_dir = dir;
+            }
+        }
+        if (best < 0)
+            break;
+        int next = options[best_dir];
+        endgame->path[endgame->path_len++] = best_dir;
+        total += endgame->reward[next];
+        mask |= 1u << next;
+        options = endgame->neighbour[next];
+    }
+
+    free(memo);
+    endgame->exact_plans++;
+    endgame->planned_reward += total;
+    return true;
+}
+
+static int compare_candidates(const void *a, const void *b)
+{
+    const beam_candidate_t *x = a, *y = b;
+    if (x->key != y->key)
+        return x->key > y->key ? -1 : 1;
+    if (x->parent != y->parent) // Desempate fijo: el resultado no depende de qsort
+        return x->parent - y->parent;
+    return x->dir - y->dir;
+}
+
+static bool bit_set(const uint64_t *bits, int cell)
+{
+    return bits[cell / BITS_PER_WORD] & (1ULL << (cell % BITS_PER_WORD));
+}
+
+// Salidas libres que le quedarían a un estado (bits) que se mueve a cell
+static int onward_moves(const endgame_t *endgame, const uint64_t *bits, int cell)
+{
+    int count = 0;
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int next = endgame->neighbour[cell][dir];
+        if (next != NO_CELL && !bit_set(bits, next))
+            count++;
+    }
+    return count;
+}
+
+// Beam search por profundidad: de cada nivel se quedan los ENDGAME_BEAM_WIDTH candidatos
+// que dejan menos salidas libres (regla de Warnsdorff: comer primero los rincones para no
+// dejar celdas sueltas atrás). Ordenar por recompensa acumulada resultó peor: el beam se
+// llena de variantes del mismo camino y los que cubren más celdas se pierden. La
+// recompensa decide al final: gana el mejor estado terminal, o el mejor vivo si se acabó
+// el tiempo.
+static bool plan_beam(endgame_t *endgame, const start_t *start)
+{
+    size_t words = (endgame->cells + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    uint64_t *bits = calloc(ENDGAME_BEAM_WIDTH * words, sizeof(uint64_t));
+    uint64_t *next_bits = calloc(ENDGAME_BEAM_WIDTH * words, sizeof(uint64_t));
+    beam_step_t *history = malloc((size_t)endgame->cells * ENDGAME_BEAM_WIDTH * sizeof(beam_step_t));
+    if (!bits || !next_bits || !history)
+    {
+        free(bits);
+        free(next_bits);
+        free(history);
+        return false;
+    }
+
+    beam_candidate_t candidates[ENDGAME_BEAM_WIDTH * DIRECTIONS_COUNT];
+    int cell[ENDGAME_BEAM_WIDTH], score[ENDGAME_BEAM_WIDTH];
+    int states = 1;
+    cell[0] = NO_CELL; // La cabeza, con nada visitado
+    score[0] = 0;
+
+    int best_score = -1;
+    unsigned int best_depth = 0;
+    int best_state = 0;
+    uint64_t started = monotonic_ns();
+    unsigned int depth = 0;
+    for (; states > 0; depth++)
+    {
+        if (endgame->time_limit_ns && monotonic_ns() - started > endgame->time_limit_ns)
+        {
+            endgame->timeouts++;
+            for (int s = 0; s < states; s++)
+            {
+                if (score[s] > best_score)
+                {
+                    best_score = score[s];
+                    best_depth = depth;
+                    best_state = s;
+                }
+            }
+            break;
+        }
+
+        int count = 0;
+        for (int s = 0; s < states; s++)
+        {
+            const uint64_t *own = &bits[s * words];
+            const short *options = cell[s] == NO_CELL ? start->slot : endgame->neighbour[cell[s]];
+            int before = count;
+            for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+            {
+                int next = options[dir];
+                if (next == NO_CELL || bit_set(own, next))
+                    continue;
+                beam_candidate_t *c = &candidates[count++];
+                c->parent = s;
+                c->cell = (short)next;
+                c->dir = dir;
+                c->score = score[s] + endgame->reward[next];
+                c->key = -(long)onward_moves(endgame, own, next);
+            }
+            if (count == before && score[s] > best_score) // Terminal: no tiene más movimientos
+            {
+                best_score = score[s];
+                best_depth = depth;
+                best_state = s;
+            }
+        }
+        if (count == 0)
+            break;
+
+        qsort(candidates, count, sizeof(beam_candidate_t), compare_candidates);
+        states = count < ENDGAME_BEAM_WIDTH ? count : ENDGAME_BEAM_WIDTH;
+        for (int s = 0; s < states; s++)
+        {
+            const beam_candidate_t *c = &candidates[s];
+            uint64_t *own = &next_bits[s * words];
+            memcpy(own, &bits[c->parent * words], words * sizeof(uint64_t));
+            own[c->cell / BITS_PER_WORD] |= 1ULL << (c->cell % BITS_PER_WORD);
+            cell[s] = c->cell;
+            score[s] = c->score;
+            history[(size_t)depth * ENDGAME_BEAM_WIDTH + s] = (beam_step_t){(short)c->parent, c->dir};
+        }
+        uint64_t *swap = bits;
+        bits = next_bits;
+        next_bits = swap;
+    }
+
+    // El estado elegido quedó en el nivel best_depth: se reconstruye hacia atrás
+    int state = best_state;
+    for (unsigned int d = best_depth; d > 0; d--)
+    {
+        const beam_step_t *step = &history[(size_t)(d - 1) * ENDGAME_BEAM_WIDTH + state];
+        endgame->path[d - 1] = step->dir;
+        state = step->parent;
+    }
+    endgame->path_len = best_depth;
+    endgame->planned_reward += best_score > 0 ? best_score : 0;
+
+    free(bits);
+    free(next_bits);
+    free(history);
+    return true;
+}
+
+// Cuartos de vuelta horarios (con y hacia abajo) después del espejo opcional en x
+static void apply_symmetry(int symmetry, int *dx, int *dy)
+{
+    if (symmetry & SYMMETRY_FLIP)
+        *dx = -*dx;
+    for (int turn = 0; turn < (symmetry & (SYMMETRY_FLIP - 1)); turn++)
+    {
+        int x = *dx;
+        *dx = -*dy;
+        *dy = x;
+    }
+}
+
+// Dirección transformada por symmetry (o por su inversa)
+static unsigned char transform_direction(int symmetry, unsigned char dir, bool inverse)
+{
+    for (unsigned char candidate = 0; candidate < DIRECTIONS_COUNT; candidate++)
+    {
+        unsigned char from = inverse ? candidate : dir;
+        unsigned char to = inverse ? dir : candidate;
+        int dx, dy, tx, ty;
+        get_direction_offset(from, &dx, &dy);
+        get_direction_offset(to, &tx, &ty);
+        apply_symmetry(symmetry, &dx, &dy);
+        if (dx == tx && dy == ty)
+            return candidate;
+    }
+    return dir;
+}
+
+static uint64_t mix64(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ULL;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+    return value;
+}
+
+// Clave de la bolsa: suma (independiente del orden) de un hash por celda con coordenadas
+// relativas a la cabeza y su recompensa. Se calcula bajo las 8 simetrías y queda la menor;
+// symmetry es la que lleva del tablero a la forma canónica.
+static poscache_key_t canonical_key(const endgame_t *endgame, const player_t *me, int *symmetry)
+{
+    uint64_t hi[SYMMETRIES], lo[SYMMETRIES];
+    for (int s = 0; s < SYMMETRIES; s++)
+        hi[s] = lo[s] = mix64(endgame->cells);
+
+    for (unsigned int i = 0; i < endgame->cells; i++)
+    {
+        for (int s = 0; s < SYMMETRIES; s++)
+        {
+            int dx = endgame->cell_x[i] - me->x, dy = endgame->cell_y[i] - me->y;
+            apply_symmetry(s, &dx, &dy);
+            uint64_t packed = (uint64_t)(uint16_t)dx << 32 | (uint64_t)(uint16_t)dy << 16 | endgame->reward[i];
+            hi[s] += mix64(packed ^ KEY_SEED_HI);
+            lo[s] += mix64(packed ^ KEY_SEED_LO);
+        }
+    }
+
+    int best = 0;
+    for (int s = 1; s < SYMMETRIES; s++)
+    {
+        if (hi[s] < hi[best] || (hi[s] == hi[best] && lo[s] < lo[best]))
+            best = s;
+    }
+    *symmetry = best;
+    poscache_key_t key = {hi[best] ? hi[best] : 1, lo[best]};
+    return key;
+}
+
+static bool load_cached_plan(endgame_t *endgame, poscache_key_t key, int symmetry)
+{
+    size_t length = poscache_lookup(endgame->cache, key, endgame->path, ENDGAME_MAX_CELLS);
+    if (length == 0)
+        return false;
+    for (size_t i = 0; i < length; i++)
+        endgame->path[i] = transform_direction(symmetry, endgame->path[i], true);
+    endgame->path_len = (unsigned int)length;
+    endgame->cache_hits++;
+    return true;
+}
+
+static void store_plan(endgame_t *endgame, poscache_key_t key, int symmetry)
+{
+    unsigned char canonical[ENDGAME_MAX_CELLS];
+    for (unsigned int i = 0; i < endgame->path_len; i++)
+        canonical[i] = transform_direction(symmetry, endgame->path[i], false);
+    poscache_insert(endgame->cache, key, canonical, endgame->path_len);
+}
+
+bool endgame_next_move(endgame_t *endgame, const board_view_t *board, unsigned int me_id, const player_t *players,
+                       unsigned char *move)
+{
+    const player_t *me = &players[me_id];
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        if (endgame->path_pos < endgame->path_len && me->x == endgame->next_x && me->y == endgame->next_y)
+        {
+            unsigned char dir = endgame->path[endgame->path_pos];
+            int dx, dy;
+            get_direction_offset(dir, &dx, &dy);
+            int x = me->x + dx, y = me->y + dy;
+            if (x >= 0 && x < board->width && y >= 0 && y < board->height &&
+                is_free(board->cells[BOARD_INDEX(board->width, x, y)]))
+            {
+                endgame->path_pos++;
+                endgame->next_x = x;
+                endgame->next_y = y;
+                *move = dir;
+                return true;
+            }
+        }
+        if (attempt == 1)
+            break;
+
+        // Sin camino (o el guardado ya no aplica): ver si estamos aislados y planear
+        endgame->path_len = 0;
+        endgame->path_pos = 0;
+        start_t start;
+        if (!find_isolated_region(endgame, board, me_id, players, &start))
+            return false;
+        poscache_key_t key;
+        int symmetry = 0;
+        if (endgame->cache)
+            key = canonical_key(endgame, me, &symmetry);
+        if (!endgame->cache || !load_cached_plan(endgame, key, symmetry))
+        {
+            unsigned long timeouts = endgame->timeouts;
+            bool planned = endgame->cells <= ENDGAME_EXACT_CELLS ? plan_exact(endgame, &start)
+                                                                 : plan_beam(endgame, &start);
+            if (!planned)
+                return false;
+            endgame->plans++;
+            // Solo caminos completos: uno cortado por tiempo no es la respuesta de esta bolsa
+            if (endgame->cache && endgame->path_len > 0 && endgame->timeouts == timeouts)
+                store_plan(endgame, key, symmetry);
+        }
+        endgame->next_x = me->x;
+        endgame->next_y = me->y;
+    }
+    return false;
+}
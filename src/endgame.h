@@ -0,0 +1,72 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include "common.h"
+#include "strategy.h"
+#include "poscache.h"
+
+// Final de partida: cuando las celdas libres a las que el jugador puede llegar forman una
+// bolsa que ningún rival alcanza, lo que queda es un problema de un solo jugador (el camino
+// de mayor recompensa dentro de la bolsa) y ya no hace falta decidir turno a turno.
+// Aislamiento: ninguna cabeza de un rival no bloqueado es vecina de la bolsa. Las celdas
+// libres nunca vuelven a liberarse, así que una bolsa aislada sigue aislada.
+//   - Hasta ENDGAME_EXACT_CELLS celdas: búsqueda exacta, memoizada por (celda, visitadas)
+//   - Hasta ENDGAME_MAX_CELLS: beam search de ENDGAME_BEAM_WIDTH estados con límite de tiempo
+//   - Más grande: no se considera final (el flood fill se corta ahí)
+// El camino se guarda y se reproduce un movimiento por turno sin volver a buscar; si la
+// posición no es la esperada (p. ej. un movimiento rechazado) se descarta y se recalcula.
+// El player lo usa por defecto, con un límite de ENDGAME_DEFAULT_LIMIT_MS: sus movimientos
+// dependen del reloj. CHOMP_ENDGAME=off lo desactiva; un número es el límite de tiempo en ms
+// (0 = sin límite, determinista). CHOMP_ENDGAME_STATS=1 imprime un resumen al terminar.
+// Con una caché de posiciones (poscache.h) los caminos completos se guardan con la bolsa
+// como clave, relativa a la cabeza y en forma canónica bajo las 8 simetrías del cuadrado:
+// la misma bolsa trasladada, rotada o espejada en otra partida reusa el camino.
+#define ENDGAME_ENV "CHOMP_ENDGAME"
+#define ENDGAME_STATS_ENV "CHOMP_ENDGAME_STATS"
+#define ENDGAME_DEFAULT_LIMIT_MS 50
+#define ENDGAME_EXACT_CELLS 16
+#define ENDGAME_MAX_CELLS 4096
+#define ENDGAME_BEAM_WIDTH 32
+
+typedef struct
+{
+    uint64_t time_limit_ns; // Tope de la beam search; 0 = sin tope (resultado determinista)
+    poscache_t *cache;      // Opcional, de quien lo crea (no se cierra en endgame_destroy)
+
+    // Camino planeado: path[path_pos] es el próximo movimiento, desde (next_x, next_y)
+    unsigned char path[ENDGAME_MAX_CELLS];
+    unsigned int path_len;
+    unsigned int path_pos;
+    int next_x, next_y;
+
+    // Bolsa actual, en el orden del flood fill
+    unsigned int cells;
+    unsigned short cell_x[ENDGAME_MAX_CELLS];
+    unsigned short cell_y[ENDGAME_MAX_CELLS];
+    unsigned char reward[ENDGAME_MAX_CELLS];
+    short neighbour[ENDGAME_MAX_CELLS][DIRECTIONS_COUNT]; // Índice en la bolsa o -1
+
+    // Marcas del flood fill por celda del tablero (con sello, para no limpiar en cada turno)
+    uint32_t *mark;
+    short *mark_slot;
+    size_t mark_size;
+    uint32_t stamp;
+
+    // Estadísticas
+    unsigned long plans;
+    unsigned long exact_plans;
+    unsigned long timeouts;
+    unsigned long cache_hits;
+    unsigned long planned_reward;
+} endgame_t;
+
+void endgame_init(endgame_t *endgame, uint64_t time_limit_ns);
+void endgame_destroy(endgame_t *endgame);
+// Si el jugador me_id está aislado, escribe en move el próximo movimiento del camino óptimo
+// (o el mejor encontrado a tiempo) y devuelve true. players tiene player_count entradas.
+bool endgame_next_move(endgame_t *endgame, const board_view_t *board, unsigned int me_id, const player_t *players,
+                       unsigned char *move);
+// Límite de tiempo según CHOMP_ENDGAME; -1 si está desactivado
+long endgame_limit_from_env(void);
+
+#endif
@@ -0,0 +1,258 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "strategy.h"
+#include "proxy_proto.h"
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Motor de referencia para ProxyPlayer (protocolo en proxy_proto.h). Juega cualquier
+// estrategia del ABI de plugins fuera del proceso del jugador. Por defecto habla por stdin
+// (el proxy lo lanza con un socketpair); con -l escucha en un socket Unix y atiende cada
+// conexión en un proceso propio, para reutilizarlo entre partidas.
+// Lanzado por el proxy no recibe argumentos: las opciones también se toman del entorno.
+#define ENGINE_STRATEGY_ENV "CHOMP_ENGINE_STRATEGY"
+#define ENGINE_THINK_ENV "CHOMP_ENGINE_THINK_MS"
+// Tope de un INIT: player_t guarda x/y en 16 bits y el tablero tiene que entrar en un payload
+#define ENGINE_MAX_SIDE UINT16_MAX
+#define ENGINE_MAX_CELLS ((UINT32_MAX - 4 * sizeof(uint32_t)) / sizeof(int32_t))
+
+typedef struct
+{
+    const chomp_strategy_t *strategy;
+    long think_ms; // Demora artificial por decisión, para probar el deadline del proxy
+} engine_config_t;
+
+// Estado de una conexión: el tablero que el proxy nos fue mandando
+typedef struct
+{
+    int fd;
+    int width;
+    int height;
+    unsigned int player_count;
+    unsigned int player_id;
+    int *board;
+    proxy_player_pos_t players[MAX_PLAYERS];
+    void *strategy_state;
+    unsigned char *buffer;
+    size_t buffer_size;
+} engine_session_t;
+
+static loaded_strategy_t plugin;
+
+void print_usage_engine(const char *program_name)
+{
+    printf("Usage: %s [-s strategy] [-d think_ms] [-l socket_path]\n", program_name);
+    printf("  -s strategy : Built-in name (greedy, perimeter, region) or plugin .so path (default: $%s or greedy)\n",
+           ENGINE_STRATEGY_ENV);
+    printf("  -d think_ms : Artificial delay per decision (default: $%s or 0)\n", ENGINE_THINK_ENV);
+    printf("  -l path     : Listen on a Unix socket instead of serving stdin\n");
+}
+
+static int ensure_buffer(engine_session_t *session, size_t size)
+{
+    if (size <= session->buffer_size)
+        return 0;
+    unsigned char *bigger = realloc(session->buffer, size);
+    if (!bigger)
+        return -1;
+    session->buffer = bigger;
+    session->buffer_size = size;
+    return 0;
+}
+
+static int handle_init(engine_session_t *session, const unsigned char *payload, uint32_t length)
+{
+    uint32_t fields[4];
+    if (length < sizeof(fields))
+        return -1;
+    memcpy(fields, payload, sizeof(fields));
+    // Todo se valida antes de calcular el tamaño o reservar: player_id indexa players[]
+    if (fields[0] < MIN_BOARD_SIZE || fields[1] < MIN_BOARD_SIZE || fields[0] > ENGINE_MAX_SIDE ||
+        fields[1] > ENGINE_MAX_SIDE || fields[2] == 0 || fields[2] > MAX_PLAYERS || fields[3] >= fields[2])
+        return -1;
+    size_t cells = BOARD_CELLS(fields[0], fields[1]);
+    if (cells > ENGINE_MAX_CELLS || length != sizeof(fields) + cells * sizeof(int32_t))
+        return -1;
+
+    session->width = fields[0];
+    session->height = fields[1];
+    session->player_count = fields[2];
+    session->player_id = fields[3];
+    free(session->board);
+    session->board = malloc(cells * sizeof(int));
+    if (!session->board)
+        return -1;
+    memcpy(session->board, payload + sizeof(fields), cells * sizeof(int32_t));
+    return 0;
+}
+
+static int handle_delta(engine_session_t *session, const unsigned char *payload, uint32_t length)
+{
+    if (!session->board || length < 2 * sizeof(uint32_t))
+        return -1;
+
+    uint32_t count;
+    memcpy(&count, payload, sizeof(count));
+    size_t offset = sizeof(count);
+    if (count != session->player_count || length < offset + count * sizeof(proxy_player_pos_t) + sizeof(uint32_t))
+        return -1;
+    memcpy(session->players, payload + offset, count * sizeof(proxy_player_pos_t));
+    offset += count * sizeof(proxy_player_pos_t);
+
+    uint32_t changes;
+    memcpy(&changes, payload + offset, sizeof(changes));
+    offset += sizeof(changes);
+    if (length != offset + (size_t)changes * sizeof(proxy_cell_change_t))
+        return -1;
+
+    size_t cells = BOARD_CELLS(session->width, session->height);
+    for (uint32_t i = 0; i < changes; i++)
+    {
+        proxy_cell_change_t change;
+        memcpy(&change, payload + offset + i * sizeof(change), sizeof(change));
+        if (change.index < cells)
+            session->board[change.index] = change.value;
+    }
+    return 0;
+}
+
+static unsigned char decide(const engine_config_t *config, engine_session_t *session)
+{
+    if (config->think_ms > 0)
+        usleep(config->think_ms * US_TO_MS);
+
+    const proxy_player_pos_t *pos = &session->players[session->player_id];
+    player_t me = {.x = pos->x, .y = pos->y, .blocked = pos->blocked};
+    board_view_t board = {session->board, session->width, session->height, session->player_count, NULL};
+    return config->strategy->choose(&board, &me, session->strategy_state);
+}
+
+// Atiende una conexión hasta END o EOF. Si ya hay otro pedido esperando no contesta el
+// actual: el proxy solo usa la respuesta al último.
+void serve(const engine_config_t *config, int fd)
+{
+    engine_session_t session = {.fd = fd};
+    if (config->strategy->state_size)
+    {
+        session.strategy_state = calloc(1, config->strategy->state_size);
+        if (!session.strategy_state)
+            error_exit("calloc strategy_state");
+    }
+
+    proxy_msg_header_t header;
+    while (proxy_recv_header(fd, &header) == 0)
+    {
+        if (ensure_buffer(&session, header.length) == -1 ||
+            proxy_recv_payload(fd, session.buffer, header.length) == -1)
+            break;
+
+        if (header.type == PROXY_MSG_END)
+            break;
+        if (header.type == PROXY_MSG_INIT)
+        {
+            if (handle_init(&session, session.buffer, header.length) == -1)
+                break;
+            continue;
+        }
+        if (header.type != PROXY_MSG_DELTA || handle_delta(&session, session.buffer, header.length) == -1)
+            break;
+
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, 0) > 0)
+            continue; // Hay un estado más nuevo en camino
+
+        unsigned char move = decide(config, &session);
+        if (move == STRATEGY_NO_MOVE)
+            move = 0; // El proxy siempre necesita una dirección; una inválida bloquea al jugador
+        if (proxy_send(fd, PROXY_MSG_MOVE, 0, header.seq, &move, sizeof(move)) == -1)
+            break;
+    }
+
+    free(session.board);
+    free(session.buffer);
+    free(session.strategy_state);
+    close(fd);
+}
+
+// Modo servidor: un proceso por conexión (cada jugador proxy es una conexión)
+void listen_forever(const engine_config_t *config, const char *path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        error_exit("socket");
+
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 || listen(fd, MAX_PLAYERS) == -1)
+        error_exit("bind/listen");
+
+    signal(SIGCHLD, SIG_IGN); // Sin zombies: nadie espera a los hijos
+    for (;;)
+    {
+        int client = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+        if (client == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            error_exit("accept");
+        }
+
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(fd);
+            serve(config, client);
+            exit(EXIT_SUCCESS);
+        }
+        if (pid == -1)
+            perror("fork");
+        close(client);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    engine_config_t config = {.strategy = &greedy_strategy, .think_ms = 0};
+    const char *listen_path = NULL;
+
+    const char *env_strategy = getenv(ENGINE_STRATEGY_ENV);
+    if (env_strategy && *env_strategy && !(config.strategy = strategy_resolve(env_strategy, &plugin)))
+        return EXIT_FAILURE;
+    const char *env_think = getenv(ENGINE_THINK_ENV);
+    if (env_think)
+        config.think_ms = atol(env_think);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:d:l:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            strategy_unload(&plugin); // -s reemplaza a la del entorno
+            config.strategy = strategy_resolve(optarg, &plugin);
+            if (!config.strategy)
+                return EXIT_FAILURE;
+            break;
+        case 'd':
+            config.think_ms = atol(optarg);
+            break;
+        case 'l':
+            listen_path = optarg;
+            break;
+        default:
+            print_usage_engine(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    if (listen_path)
+        listen_forever(&config, listen_path);
+    else
+        serve(&config, STDIN_FILENO);
+
+    strategy_unload(&plugin);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,248 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "frame_stream.h"
+#include <stdarg.h>
+
+#define FRAME_RECORD_SLACK 256 // Lo más largo que se escribe de una vez (un jugador en ndjson)
+#define BINARY_HEADER_BYTES 16
+#define BINARY_CHANGE_BYTES 8
+#define BINARY_PLAYER_BYTES (20 + PLAYER_NAME_SIZE)
+#define UNSEEN_CELL INT_MIN   // previous antes del primer registro: todo cuenta como cambio
+
+static const char *const output_names[] = {"ansi", "ndjson", "binary"};
+
+int frame_output_parse(const char *name, frame_output_t *out)
+{
+    for (size_t i = 0; i < sizeof(output_names) / sizeof(output_names[0]); i++)
+    {
+        if (strcmp(name, output_names[i]) == 0)
+        {
+            *out = (frame_output_t)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void flush_buffer(frame_stream_t *stream)
+{
+    if (stream->used && !stream->failed)
+    {
+        if (write_all(stream->fd, stream->buffer, stream->used) == -1)
+        {
+            perror("frame stream write");
+            stream->failed = true;
+        }
+        else
+            stream->bytes += stream->used;
+    }
+    stream->used = 0;
+}
+
+// Deja lugar para al menos bytes en el buffer
+static unsigned char *reserve(frame_stream_t *stream, size_t bytes)
+{
+    if (stream->used + bytes > FRAME_BUFFER_BYTES)
+        flush_buffer(stream);
+    return stream->buffer + stream->used;
+}
+
+static void put_bytes(frame_stream_t *stream, const void *data, size_t size)
+{
+    memcpy(reserve(stream, size), data, size);
+    stream->used += size;
+}
+
+static void put_u8(frame_stream_t *stream, uint8_t value)
+{
+    put_bytes(stream, &value, 1);
+}
+
+static void put_u16(frame_stream_t *stream, uint16_t value)
+{
+    unsigned char bytes[2] = {value & 0xFF, value >> 8};
+    put_bytes(stream, bytes, sizeof(bytes));
+}
+
+static void put_u32(frame_stream_t *stream, uint32_t value)
+{
+    unsigned char bytes[4] = {value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, value >> 24};
+    put_bytes(stream, bytes, sizeof(bytes));
+}
+
+static void put_text(frame_stream_t *stream, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void put_text(frame_stream_t *stream, const char *format, ...)
+{
+    char *out = (char *)reserve(stream, FRAME_RECORD_SLACK);
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(out, FRAME_RECORD_SLACK, format, args);
+    va_end(args);
+    if (length > 0)
+        stream->used += length < FRAME_RECORD_SLACK ? (size_t)length : FRAME_RECORD_SLACK - 1;
+}
+
+// Nombre como string JSON: comillas, barras y controles escapados
+static void put_json_name(frame_stream_t *stream, const char *name)
+{
+    put_u8(stream, '"');
+    for (size_t i = 0; i < PLAYER_NAME_SIZE && name[i]; i++)
+    {
+        unsigned char c = (unsigned char)name[i];
+        if (c == '"' || c == '\\')
+        {
+            put_u8(stream, '\\');
+            put_u8(stream, c);
+        }
+        else if (c < 0x20)
+            put_text(stream, "\\u%04x", c);
+        else
+            put_u8(stream, c);
+    }
+    put_u8(stream, '"');
+}
+
+int frame_stream_open(frame_stream_t *stream, frame_output_t format, const char *path, unsigned int every,
+                      int width, int height)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->format = format;
+    stream->every = every ? every : 1;
+    stream->width = width;
+    stream->height = height;
+
+    size_t cells = (size_t)width * height;
+    stream->previous = malloc(sizeof(int) * cells);
+    stream->changed = malloc(sizeof(uint32_t) * cells);
+    stream->buffer = malloc(FRAME_BUFFER_BYTES);
+    if (!stream->previous || !stream->changed || !stream->buffer)
+    {
+        frame_stream_close(stream);
+        return -1;
+    }
+    for (size_t i = 0; i < cells; i++)
+        stream->previous[i] = UNSEEN_CELL;
+
+    stream->fd = STDOUT_FILENO;
+    if (path && *path)
+    {
+        stream->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, SHM_PERMISSIONS);
+        if (stream->fd == -1)
+        {
+            perror("frame stream open");
+            frame_stream_close(stream);
+            return -1;
+        }
+        stream->owns_fd = true;
+    }
+    return 0;
+}
+
+static void write_ndjson(frame_stream_t *stream, const game_state_t *state, const int *cells, size_t changes,
+                         int winner)
+{
+    put_text(stream, "{\"frame\":%lu,\"finished\":%s,\"winner\":%d,\"width\":%d,\"height\":%d,\"cells\":[",
+             (unsigned long)stream->notified - 1, state->game_finished ? "true" : "false", winner, stream->width,
+             stream->height);
+    for (size_t i = 0; i < changes; i++)
+    {
+        uint32_t at = stream->changed[i];
+        put_text(stream, "%s[%u,%u,%d]", i ? "," : "", at % (uint32_t)stream->width, at / (uint32_t)stream->width,
+                 cells[at]);
+    }
+    put_text(stream, "],\"players\":[");
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        player_t p;
+        get_player((game_state_t *)state, i, &p);
+        put_text(stream, "%s{\"id\":%u,\"name\":", i ? "," : "", i);
+        put_json_name(stream, p.name);
+        put_text(stream, ",\"x\":%u,\"y\":%u,\"score\":%u,\"valid\":%u,\"invalid\":%u,\"blocked\":%s}", p.x, p.y,
+                 p.score, p.valid_moves, p.invalid_moves, p.blocked ? "true" : "false");
+    }
+    put_text(stream, "]}\n");
+}
+
+static void write_binary(frame_stream_t *stream, const game_state_t *state, const int *cells, size_t changes,
+                         int winner)
+{
+    size_t length = BINARY_HEADER_BYTES + changes * BINARY_CHANGE_BYTES + state->player_count * BINARY_PLAYER_BYTES;
+    put_u32(stream, FRAME_BINARY_MAGIC);
+    put_u32(stream, (uint32_t)length);
+    put_u32(stream, (uint32_t)(stream->notified - 1));
+    put_u16(stream, (uint16_t)stream->width);
+    put_u16(stream, (uint16_t)stream->height);
+    put_u8(stream, (uint8_t)state->player_count);
+    put_u8(stream, state->game_finished);
+    put_u8(stream, (uint8_t)(int8_t)winner);
+    put_u8(stream, 0);
+    put_u32(stream, (uint32_t)changes);
+    for (size_t i = 0; i < changes; i++)
+    {
+        uint32_t at = stream->changed[i];
+        put_u16(stream, (uint16_t)(at % (uint32_t)stream->width));
+        put_u16(stream, (uint16_t)(at / (uint32_t)stream->width));
+        put_u32(stream, (uint32_t)cells[at]);
+    }
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        player_t p;
+        get_player((game_state_t *)state, i, &p);
+        put_u16(stream, p.x);
+        put_u16(stream, p.y);
+        put_u32(stream, p.score);
+        put_u32(stream, p.valid_moves);
+        put_u32(stream, p.invalid_moves);
+        put_u8(stream, p.blocked);
+        put_u8(stream, 0);
+        put_u16(stream, 0);
+        char name[PLAYER_NAME_SIZE] = {0};
+        memcpy(name, p.name, strnlen(p.name, PLAYER_NAME_SIZE - 1));
+        put_bytes(stream, name, sizeof(name));
+    }
+}
+
+void frame_stream_frame(frame_stream_t *stream, const game_state_t *state, const int *cells)
+{
+    stream->notified++;
+    if (stream->failed || (!state->game_finished && (stream->notified - 1) % stream->every != 0))
+        return;
+
+    // Cambios contra el último registro escrito: los frames salteados se acumulan acá
+    size_t count = (size_t)stream->width * stream->height;
+    size_t changes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (cells[i] != stream->previous[i])
+        {
+            stream->changed[changes++] = (uint32_t)i;
+            stream->previous[i] = cells[i];
+        }
+    }
+
+    int winner = state->game_finished ? find_winner((game_state_t *)state) : -1;
+    if (stream->format == FRAME_OUTPUT_BINARY)
+        write_binary(stream, state, cells, changes, winner);
+    else
+        write_ndjson(stream, state, cells, changes, winner);
+    stream->written++;
+
+    // El último registro no espera a que se llene el buffer
+    if (state->game_finished)
+        flush_buffer(stream);
+}
+
+int frame_stream_close(frame_stream_t *stream)
+{
+    if (stream->buffer)
+        flush_buffer(stream);
+    if (stream->owns_fd)
+        close(stream->fd);
+    free(stream->previous);
+    free(stream->changed);
+    free(stream->buffer);
+    bool failed = stream->failed;
+    memset(stream, 0, sizeof(*stream));
+    return failed ? -1 : 0;
+}
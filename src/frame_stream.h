@@ -0,0 +1,64 @@
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include "common.h"
+
+// Salida de la vista para otras herramientas: en vez de dibujar con ANSI, cada frame que
+// notifica el máster se escribe como un registro con las celdas que cambiaron desde el
+// último registro escrito (el primero las trae todas) y la tabla de jugadores.
+// El máster lanza la vista solo con <width> <height>, así que se configura por entorno:
+//   CHOMP_VIEW_OUTPUT  ansi (por defecto), ndjson o binary
+//   CHOMP_VIEW_FILE    archivo o FIFO de salida (por defecto stdout)
+//   CHOMP_VIEW_EVERY   escribir uno de cada N frames; el final se escribe siempre
+// Se escribe por un buffer de FRAME_BUFFER_BYTES con write(2), sin stdio.
+//
+// ndjson, una línea por frame:
+//   {"frame":N,"finished":false,"winner":-1,"width":W,"height":H,"cells":[[x,y,v],...],
+//    "players":[{"id":0,"name":"...","x":0,"y":0,"score":0,"valid":0,"invalid":0,"blocked":false},...]}
+// binary, enteros little-endian:
+//   u32 magic (FRAME_BINARY_MAGIC)  u32 largo del resto del registro
+//   u32 frame  u16 width  u16 height  u8 players  u8 finished  i8 winner  u8 0  u32 cambios
+//   cambios × (u16 x, u16 y, i32 valor)
+//   players × (u16 x, u16 y, u32 score, u32 valid, u32 invalid, u8 blocked, u8 0, u16 0, char name[16])
+#define VIEW_OUTPUT_ENV "CHOMP_VIEW_OUTPUT"
+#define VIEW_FILE_ENV "CHOMP_VIEW_FILE"
+#define VIEW_EVERY_ENV "CHOMP_VIEW_EVERY"
+#define FRAME_BUFFER_BYTES (1u << 20)
+#define FRAME_BINARY_MAGIC 0x46504843u // "CHPF"
+
+typedef enum
+{
+    FRAME_OUTPUT_ANSI = 0,
+    FRAME_OUTPUT_NDJSON,
+    FRAME_OUTPUT_BINARY
+} frame_output_t;
+
+typedef struct
+{
+    frame_output_t format;
+    int fd;
+    bool owns_fd;
+    bool failed;         // Falló una escritura (p. ej. se cerró el pipe): se descarta el resto
+    unsigned int every;
+    uint64_t notified;   // Frames recibidos
+    uint64_t written;    // Registros escritos
+    uint64_t bytes;
+    int width, height;
+    int *previous;       // Tablero del último registro, en orden de filas
+    uint32_t *changed;   // Índices que cambiaron, armado en cada registro
+    unsigned char *buffer;
+    size_t used;
+} frame_stream_t;
+
+// "ansi", "ndjson" o "binary"; -1 si no se entiende
+int frame_output_parse(const char *name, frame_output_t *out);
+// path NULL: stdout. -1 si no se pudo abrir o reservar
+int frame_stream_open(frame_stream_t *stream, frame_output_t format, const char *path, unsigned int every,
+                      int width, int height);
+// Un frame notificado; cells es el tablero en orden de filas. Escribe si toca (every) o si
+// la partida terminó
+void frame_stream_frame(frame_stream_t *stream, const game_state_t *state, const int *cells);
+// Vacía el buffer y cierra; -1 si alguna escritura falló
+int frame_stream_close(frame_stream_t *stream);
+
+#endif
@@ -0,0 +1,322 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "common.h"
+#include "turnsync.h"
+
+// Jugador generador de carga para estresar al máster (select/read y sección crítica de
+// state_mutex). Se lanza como cualquier player (-p ./loadgen) y se configura por entorno,
+// que el máster le pasa intacto:
+//   CHOMP_LOADGEN_MODE     flood  escribe sin esperar turno, tan rápido como acepte el pipe
+//                          burst  ráfagas de BURST movimientos separadas por PAUSE_MS
+//                          slow   espera su turno y retiene cada movimiento HOLD_MS
+//                          sync   espera su turno como player, sin copiar el tablero
+//   CHOMP_LOADGEN_INVALID  fracción de movimientos inválidos a propósito (0..1)
+//   CHOMP_LOADGEN_BURST, CHOMP_LOADGEN_PAUSE_MS, CHOMP_LOADGEN_HOLD_MS, CHOMP_LOADGEN_MOVES (0 = sin límite)
+//   CHOMP_LOADGEN_LOG      directorio donde guardar loadgen-<pid>.log con el timestamp de cada envío
+#define LOADGEN_MODE_ENV "CHOMP_LOADGEN_MODE"
+#define LOADGEN_INVALID_ENV "CHOMP_LOADGEN_INVALID"
+#define LOADGEN_BURST_ENV "CHOMP_LOADGEN_BURST"
+#define LOADGEN_PAUSE_ENV "CHOMP_LOADGEN_PAUSE_MS"
+#define LOADGEN_HOLD_ENV "CHOMP_LOADGEN_HOLD_MS"
+#define LOADGEN_MOVES_ENV "CHOMP_LOADGEN_MOVES"
+#define LOADGEN_LOG_ENV "CHOMP_LOADGEN_LOG"
+#define DEFAULT_LOADGEN_BURST 64
+#define DEFAULT_LOADGEN_PAUSE_MS 10
+#define DEFAULT_LOADGEN_HOLD_MS 50
+#define LOADGEN_LOG_CAPACITY (1 << 20) // Envíos registrados; los siguientes no se guardan
+
+typedef enum
+{
+    LOAD_FLOOD = 0,
+    LOAD_BURST,
+    LOAD_SLOW,
+    LOAD_SYNC
+} load_mode_t;
+
+static const char *mode_names[] = {"flood", "burst", "slow", "sync"};
+
+typedef struct
+{
+    load_mode_t mode;
+    double invalid_ratio;
+    long burst;
+    long pause_ms;
+    long hold_ms;
+    long max_moves;
+    const char *log_dir;
+} load_config_t;
+
+// Un envío: cuándo, qué dirección y si se buscaba que fuera válido
+typedef struct
+{
+    uint64_t send_ns;
+    unsigned char direction;
+    unsigned char intended_valid;
+} send_record_t;
+
+static game_state_t *game_state = NULL;
+static game_sync_t *game_sync = NULL;
+static int player_id = -1;
+static send_record_t *send_log = NULL;
+static size_t send_count = 0;
+
+// Modelo local: el tablero visto al arrancar más los movimientos propios. En flood el
+// máster puede estar miles de movimientos atrás, así que no sirve releer la posición.
+static int *local_board = NULL;
+static int local_x, local_y;
+static uint64_t rng_state;
+
+void cleanup_loadgen(void)
+{
+    cleanup_shared_memory(game_state, game_sync);
+    free(local_board);
+    local_board = NULL;
+    free(send_log);
+    send_log = NULL;
+}
+
+void signal_handler(int sig)
+{
+    (void)sig;
+    cleanup_loadgen();
+    exit(EXIT_FAILURE);
+}
+
+static long env_long(const char *name, long fallback)
+{
+    const char *value = getenv(name);
+    return value && *value ? atol(value) : fallback;
+}
+
+// -1 si el modo no se entiende: medir otra carga sin avisar es peor que no medir
+int load_config(load_config_t *config)
+{
+    config->mode = LOAD_FLOOD;
+    const char *mode = getenv(LOADGEN_MODE_ENV);
+    if (mode && *mode)
+    {
+        size_t i = 0;
+        while (i < sizeof(mode_names) / sizeof(mode_names[0]) && strcmp(mode, mode_names[i]) != 0)
+            i++;
+        if (i == sizeof(mode_names) / sizeof(mode_names[0]))
+        {
+            fprintf(stderr, "Unknown %s '%s' (flood, burst, slow, sync)\n", LOADGEN_MODE_ENV, mode);
+            return -1;
+        }
+        config->mode = (load_mode_t)i;
+    }
+
+    const char *ratio = getenv(LOADGEN_INVALID_ENV);
+    config->invalid_ratio = ratio ? atof(ratio) : 0.0;
+    if (config->invalid_ratio < 0.0)
+        config->invalid_ratio = 0.0;
+    if (config->invalid_ratio > 1.0)
+        config->invalid_ratio = 1.0;
+
+    config->burst = env_long(LOADGEN_BURST_ENV, DEFAULT_LOADGEN_BURST);
+    config->pause_ms = env_long(LOADGEN_PAUSE_ENV, DEFAULT_LOADGEN_PAUSE_MS);
+    config->hold_ms = env_long(LOADGEN_HOLD_ENV, DEFAULT_LOADGEN_HOLD_MS);
+    config->max_moves = env_long(LOADGEN_MOVES_ENV, 0);
+    config->log_dir = getenv(LOADGEN_LOG_ENV);
+    if (config->burst < 1)
+        config->burst = 1;
+    return 0;
+}
+
+// Id por entorno o, con el máster de referencia, buscando el pid (una sola vez)
+int find_player_id(void)
+{
+    int id = player_id_from_env(game_state);
+    if (id != -1)
+        return id;
+
+    read_lock_state(game_sync);
+    for (unsigned int i = 0; i < game_state->player_count && id == -1; i++)
+    {
+        if (PLAYER_PID(game_state, i) == getpid())
+            id = i;
+    }
+    read_unlock_state(game_sync);
+    return id;
+}
+
+void snapshot_board(void)
+{
+    size_t cells = BOARD_CELLS(game_state->width, game_state->height);
+    local_board = malloc(cells * sizeof(int));
+    if (!local_board)
+        error_exit("malloc local_board");
+
+    read_lock_state(game_sync);
+    memcpy(local_board, game_state->board, cells * sizeof(int));
+    local_x = PLAYER_X(game_state, player_id);
+    local_y = PLAYER_Y(game_state, player_id);
+    read_unlock_state(game_sync);
+}
+
+static uint64_t next_random(void)
+{
+    // xorshift64: barato y suficiente para repartir direcciones
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static bool local_free(int x, int y)
+{
+    if (x < 0 || x >= game_state->width || y < 0 || y >= game_state->height)
+        return false;
+    int value = local_board[BOARD_INDEX(game_state->width, x, y)];
+    return value >= MIN_REWARD && value <= MAX_REWARD;
+}
+
+// Elige una dirección válida o inválida según el modelo local, empezando por una al azar.
+// Si no hay ninguna del tipo pedido devuelve la primera de la otra clase.
+unsigned char pick_direction(bool want_valid, bool *is_valid)
+{
+    unsigned char start = next_random() % DIRECTIONS_COUNT;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < DIRECTIONS_COUNT; i++)
+        {
+            unsigned char dir = (start + i) % DIRECTIONS_COUNT;
+            int dx, dy;
+            get_direction_offset(dir, &dx, &dy);
+            if (local_free(local_x + dx, local_y + dy) == want_valid)
+            {
+                *is_valid = want_valid;
+                return dir;
+            }
+        }
+        want_valid = !want_valid;
+    }
+    *is_valid = false;
+    return start;
+}
+
+// Envía un movimiento y actualiza el modelo local; false si el máster cerró el pipe
+bool send_move(const load_config_t *config)
+{
+    bool want_valid = (double)(next_random() % 1000000) / 1000000.0 >= config->invalid_ratio;
+    bool is_valid;
+    unsigned char dir = pick_direction(want_valid, &is_valid);
+
+    uint64_t now = monotonic_ns();
+    if (write(STDOUT_FILENO, &dir, 1) != 1)
+        return false;
+
+    if (send_log && send_count < LOADGEN_LOG_CAPACITY)
+        send_log[send_count] = (send_record_t){now, dir, is_valid};
+    send_count++;
+
+    if (is_valid)
+    {
+        int dx, dy;
+        get_direction_offset(dir, &dx, &dy);
+        local_x += dx;
+        local_y += dy;
+        local_board[BOARD_INDEX(game_state->width, local_x, local_y)] = -player_id;
+    }
+    return true;
+}
+
+// Formato: una línea por envío "<seq> <send_ns> <direction> <intended_valid>"
+void write_send_log(const load_config_t *config)
+{
+    if (!config->log_dir || !send_log)
+        return;
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/loadgen-%d.log", config->log_dir, getpid());
+    FILE *out = fopen(path, "w");
+    if (!out)
+    {
+        perror(path);
+        return;
+    }
+    size_t logged = send_count < LOADGEN_LOG_CAPACITY ? send_count : LOADGEN_LOG_CAPACITY;
+    for (size_t i = 0; i < logged; i++)
+        fprintf(out, "%zu %lu %u %u\n", i, (unsigned long)send_log[i].send_ns, send_log[i].direction,
+                send_log[i].intended_valid);
+    fclose(out);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        print_usage_player(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGPIPE, SIG_IGN); // Fin del juego: write devuelve EPIPE en vez de matar el proceso
+
+    int width = atoi(argv[1]);
+    int height = atoi(argv[2]);
+    if (width < MIN_BOARD_SIZE || height < MIN_BOARD_SIZE)
+    {
+        fprintf(stderr, "Invalid board dimensions\n");
+        return EXIT_FAILURE;
+    }
+
+    load_config_t config;
+    if (load_config(&config) == -1)
+        return EXIT_FAILURE;
+
+    if (connect_shared_memory(width, height, &game_state, &game_sync) != 0)
+        error_exit("connect_shared_memory");
+
+    player_id = find_player_id();
+    if (player_id == -1)
+    {
+        fprintf(stderr, "Could not find player ID\n");
+        cleanup_loadgen();
+        return EXIT_FAILURE;
+    }
+
+    if (config.log_dir)
+    {
+        send_log = malloc(LOADGEN_LOG_CAPACITY * sizeof(send_record_t));
+        if (!send_log)
+            error_exit("malloc send_log");
+    }
+    rng_state = ((uint64_t)getpid() << 32) ^ monotonic_ns() ^ 0x9E3779B97F4A7C15ULL;
+    snapshot_board();
+
+    uint64_t start = monotonic_ns();
+    bool turn_based = config.mode == LOAD_SLOW || config.mode == LOAD_SYNC;
+    long in_burst = 0;
+
+    while (config.max_moves == 0 || (long)send_count < config.max_moves)
+    {
+        if (turn_based)
+            turn_wait(game_sync, player_id);
+
+        // Lectura sin lock a propósito: un bool, y llegar tarde una vuelta no importa
+        if (__atomic_load_n(&game_state->game_finished, __ATOMIC_RELAXED))
+            break;
+
+        if (config.mode == LOAD_SLOW && config.hold_ms > 0)
+            usleep(config.hold_ms * US_TO_MS);
+
+        if (!send_move(&config))
+            break;
+
+        if (config.mode == LOAD_BURST && ++in_burst >= config.burst)
+        {
+            in_burst = 0;
+            usleep(config.pause_ms * US_TO_MS);
+        }
+    }
+
+    double elapsed = (double)(monotonic_ns() - start) / NS_PER_SECOND;
+    fprintf(stderr, "[loadgen %d] mode=%s sent=%zu in %.3f s (%.0f moves/s)\n", player_id, mode_names[config.mode],
+            send_count, elapsed, elapsed > 0 ? send_count / elapsed : 0.0);
+
+    write_send_log(&config);
+    cleanup_loadgen();
+    return EXIT_SUCCESS;
+}
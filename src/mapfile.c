@@ -0,0 +1,167 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "mapfile.h"
+
+#define MAP_TMP_SUFFIX ".tmp"
+
+static size_t map_cells_offset(void)
+{
+    return (sizeof(map_header_t) + MAP_CELLS_ALIGN - 1) / MAP_CELLS_ALIGN * MAP_CELLS_ALIGN;
+}
+
+int map_open(map_file_t *map, const char *path)
+{
+    memset(map, 0, sizeof(*map));
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(map_header_t))
+    {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return -1;
+
+    map->data = data;
+    map->size = st.st_size;
+    map->header = data;
+
+    const map_header_t *header = map->header;
+    size_t cells_size = sizeof(int) * header->width * header->height;
+    if (memcmp(header->magic, MAP_MAGIC, MAP_MAGIC_SIZE) != 0 || header->version != MAP_VERSION ||
+        header->cells_offset % MAP_CELLS_ALIGN != 0 || header->cells_offset + cells_size > map->size ||
+        header->width < MIN_BOARD_SIZE || header->height < MIN_BOARD_SIZE || header->player_count > MAX_PLAYERS)
+    {
+        map_close(map);
+        errno = EINVAL;
+        return -1;
+    }
+
+    map->cells = (const int *)((const char *)data + header->cells_offset);
+    madvise((void *)map->cells, cells_size, MADV_SEQUENTIAL);
+    return 0;
+}
+
+// Copia las celdas del mapa (en orden de filas) al tablero (mismas dimensiones que el estado)
+void map_load_board(const map_file_t *map, game_state_t *state)
+{
+    board_from_rowmajor(state, map->cells);
+}
+
+// Restaura los jugadores de un checkpoint; falla si el mapa no los tiene o no coinciden.
+// Cada posición tiene que estar dentro del tablero y sobre una celda del propio jugador (-i);
+// se valida todo antes de escribir, así el estado queda intacto si hay que ubicarlos de nuevo
+bool map_restore_players(const map_file_t *map, game_state_t *state)
+{
+    const map_header_t *header = map->header;
+    if (!(header->flags & MAP_FLAG_PLAYERS) || header->player_count != state->player_count)
+        return false;
+
+    for (unsigned int i = 0; i < header->player_count; i++)
+    {
+        const map_player_t *p = &header->players[i];
+        if (p->x >= state->width || p->y >= state->height || get_board_cell(state, p->x, p->y) != -(int)i)
+            return false;
+    }
+
+    for (unsigned int i = 0; i < header->player_count; i++)
+    {
+        const map_player_t *p = &header->players[i];
+        memcpy(PLAYER_NAME(state, i), p->name, PLAYER_NAME_SIZE);
+        PLAYER_NAME(state, i)[PLAYER_NAME_SIZE - 1] = '\0';
+        PLAYER_SCORE(state, i) = p->score;
+        PLAYER_INVALID_MOVES(state, i) = p->invalid_moves;
+        PLAYER_VALID_MOVES(state, i) = p->valid_moves;
+        PLAYER_X(state, i) = p->x;
+        PLAYER_Y(state, i) = p->y;
+        PLAYER_BLOCKED(state, i) = p->blocked;
+    }
+    return true;
+}
+
+void map_close(map_file_t *map)
+{
+    if (map->data)
+        munmap((void *)map->data, map->size);
+    memset(map, 0, sizeof(*map));
+}
+
+// Guarda el estado en un archivo temporal y lo renombra, así nunca queda un mapa a medias
+int map_save(const char *path, game_state_t *state, bool with_players)
+{
+    map_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAP_MAGIC, MAP_MAGIC_SIZE);
+    header.version = MAP_VERSION;
+    header.cells_offset = map_cells_offset();
+    header.width = state->width;
+    header.height = state->height;
+
+    if (with_players)
+    {
+        header.flags |= MAP_FLAG_PLAYERS;
+        header.player_count = state->player_count;
+        for (unsigned int i = 0; i < state->player_count; i++)
+        {
+            map_player_t *p = &header.players[i];
+            memcpy(p->name, PLAYER_NAME(state, i), PLAYER_NAME_SIZE);
+            p->score = PLAYER_SCORE(state, i);
+            p->invalid_moves = PLAYER_INVALID_MOVES(state, i);
+            p->valid_moves = PLAYER_VALID_MOVES(state, i);
+            p->x = PLAYER_X(state, i);
+            p->y = PLAYER_Y(state, i);
+            p->blocked = PLAYER_BLOCKED(state, i);
+        }
+    }
+
+    size_t path_len = strlen(path);
+    char *tmp_path = malloc(path_len + sizeof(MAP_TMP_SUFFIX));
+    if (!tmp_path)
+        return -1;
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, MAP_TMP_SUFFIX, sizeof(MAP_TMP_SUFFIX));
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, SHM_PERMISSIONS);
+    if (fd == -1)
+    {
+        free(tmp_path);
+        return -1;
+    }
+
+    // El archivo siempre va en orden de filas: con BOARD=tiled se convierte antes de escribir
+    size_t cells_size = sizeof(int) * state->width * state->height;
+    const int *cells = state->board;
+    int *rows = NULL;
+    if (!BOARD_ROWMAJOR)
+    {
+        rows = malloc(cells_size);
+        if (rows)
+            board_to_rowmajor(state, rows);
+        cells = rows;
+    }
+
+    int result = 0;
+    if (!cells || write_all(fd, &header, sizeof(header)) == -1 ||
+        lseek(fd, header.cells_offset, SEEK_SET) == -1 ||
+        write_all(fd, cells, cells_size) == -1)
+        result = -1;
+    free(rows);
+
+    if (close(fd) == -1)
+        result = -1;
+    if (result == 0 && rename(tmp_path, path) == -1)
+        result = -1;
+    if (result == -1)
+        unlink(tmp_path);
+
+    free(tmp_path);
+    return result;
+}
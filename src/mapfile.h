@@ -0,0 +1,57 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include "common.h"
+
+// Formato de mapa en disco (versionado):
+//   map_header_t al comienzo del archivo
+//   relleno hasta cells_offset (múltiplo de MAP_CELLS_ALIGN)
+//   width * height celdas int32 en el mismo orden que game_state_t.board
+// Como las celdas quedan alineadas a página se pueden mapear con mmap y copiar
+// directo al segmento compartido. Si el mapa es un checkpoint (MAP_FLAG_PLAYERS)
+// también guarda el estado de cada jugador para retomar la partida.
+#define MAP_MAGIC "CHMP"
+#define MAP_MAGIC_SIZE 4
+#define MAP_VERSION 1
+#define MAP_CELLS_ALIGN 4096
+
+#define MAP_FLAG_PLAYERS 0x1
+
+typedef struct
+{
+    char name[PLAYER_NAME_SIZE];
+    uint32_t score;
+    uint32_t invalid_moves;
+    uint32_t valid_moves;
+    uint16_t x, y;
+    uint8_t blocked;
+    uint8_t reserved[3];
+} map_player_t;
+
+typedef struct
+{
+    char magic[MAP_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t cells_offset;
+    uint32_t flags;
+    uint16_t width;
+    uint16_t height;
+    uint32_t player_count;
+    map_player_t players[MAX_PLAYERS];
+} map_header_t;
+
+typedef struct
+{
+    const void *data;
+    size_t size;
+    const map_header_t *header;
+    const int *cells;
+} map_file_t;
+
+int map_open(map_file_t *map, const char *path);
+void map_load_board(const map_file_t *map, game_state_t *state);
+bool map_restore_players(const map_file_t *map, game_state_t *state);
+void map_close(map_file_t *map);
+int map_save(const char *path, game_state_t *state, bool with_players);
+
+#endif
@@ -1,16 +1,60 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include "common.h"
+#include "replay.h"
+#include "board_gen.h"
+#include "mapfile.h"
+#include "stats.h"
+#include "trace.h"
+#include "probes.h"
+#include "sim.h"
+#include "turnsync.h"
+#include "reward_index.h"
+#include "rules.h"
+#include "board_scan.h"
+#include "scheduler.h"
 
 // Variables globales para limpieza
-static int state_shm_fd = INVALID_FD;
-static int sync_shm_fd = INVALID_FD;
 static game_state_t *game_state = NULL; //Estado logico del juego
 static game_sync_t *game_sync = NULL; // Estructura de sincronización
 static pid_t *player_pids = NULL;
 static pid_t view_pid = INVALID_FD;
 static int **player_pipes = NULL;
 static int player_count = 0;
+static replay_writer_t replay_writer = {.fd = INVALID_FD};
+static volatile sig_atomic_t checkpoint_requested = 0;
+static int shm_flags = 0; // SHM_FLAG_* con los que se crearon los segmentos
+static game_stats_t *game_stats = NULL; // Segmento de estadísticas en vivo (NULL si no se pudo crear)
+static uint64_t state_locked_at = 0;
+static uint64_t turn_granted_at[MAX_PLAYERS]; // Cuándo se habilitó a cada jugador a mover
+static uint64_t master_start_ns = 0;           // Referencia para las métricas de arranque
+static uint64_t first_move_at = 0;
+static loaded_strategy_t *strategies = NULL; // Modo --inproc: un plugin por jugador
+static sim_game_t inproc_game;               // Modo --inproc: partida sobre el estado compartido
+static reward_index_t *reward_index = NULL;  // Recompensa restante publicada a los jugadores (NULL si no se pudo crear)
+static const rule_kernels_t *game_rules;     // Reglas especializadas para el tamaño del tablero (rules.h)
+static scheduler_t scheduler;                // Cola de listos del game loop (scheduler.h)
+
+extern char **environ;
+
+// Opciones largas sin equivalente corto
+enum
+{
+    OPT_RNG = 256,
+    OPT_PROFILE,
+    OPT_GEN_THREADS,
+    OPT_MAP,
+    OPT_SAVE_MAP,
+    OPT_NS,
+    OPT_RESULT,
+    OPT_MEMFD,
+    OPT_INPROC,
+    OPT_FUTEX,
+    OPT_SCHED,
+    OPT_HUGEPAGES,
+    OPT_PREFAULT,
+    OPT_MLOCK
+};
 
 // Configuración del juego
 typedef struct
@@ -20,13 +64,26 @@ typedef struct
     int delay;
     int timeout;
     unsigned int seed;
+    board_gen_t board_gen;
     char *view_path;
+    char *replay_path;
+    char *map_path;
+    char *save_map_path;
+    char *result_path;
+    int shm_flags;
+    bool inproc; // player_paths son plugins .so que se llaman desde el game loop
+    uint32_t turn_mode; // TURN_MODE_*: semáforos POSIX o futex con espera activa
+    scheduler_policy_t sched_policy; // A qué jugador listo se atiende primero
+    uint32_t sched_weights[MAX_PLAYERS]; // Pesos de wfq
     char **player_paths;
     int player_count;
 } game_config_t;
 
 void cleanup_resources(void)
 {
+    // Volcar lo que quede del replay (también si salimos por señal)
+    replay_writer_close(&replay_writer);
+
     // Cerrar pipes
     if (player_pipes) // los vuelvo a cerrar aca porque en caso de salir del gameloop de forma anticipada me aseguro de cerrarlos
     {
@@ -50,18 +107,28 @@ void cleanup_resources(void)
         free(player_pipes);
     }
 
-    if (game_state) // saco el mapeo de memoria en mi proceso
-        munmap(game_state, sizeof(game_state_t) + sizeof(int) * game_state->width * game_state->height);
-    if (game_sync)
-        munmap(game_sync, sizeof(game_sync_t));
-    if (state_shm_fd != -1) // libera los descriptores
-        close(state_shm_fd);
-    if (sync_shm_fd != -1)
-        close(sync_shm_fd);
-
-    shm_unlink(GAME_STATE_SHM); // elimina la entrada a la shared memory
-    shm_unlink(GAME_SYNC_SHM);  // hasta que los procesos que la usan no la cierren
-                                // el kernel no liberara la memoria
+    stats_destroy(game_stats);
+    game_stats = NULL;
+    reward_index_destroy(reward_index, shm_flags);
+    reward_index = NULL;
+
+    if (strategies)
+    {
+        sim_game_destroy(&inproc_game);
+        for (int i = 0; i < player_count; i++)
+            strategy_unload(&strategies[i]);
+        free(strategies);
+        strategies = NULL;
+    }
+
+    cleanup_shared_memory(game_state, game_sync); // saco el mapeo de memoria en mi proceso
+    game_state = NULL;
+    game_sync = NULL;
+
+    if (!(shm_flags & SHM_FLAG_MEMFD)) // los memfd no tienen nombre: se liberan con el último close/munmap
+        unlink_shared_memory();        // elimina la entrada a la shared memory
+                                       // hasta que los procesos que la usan no la cierren
+                                       // el kernel no liberara la memoria
     if (player_pids)            // esto se hace en el master porque se supne que es el ultimo bro
         free(player_pids);
 }
@@ -73,6 +140,13 @@ void signal_handler(int sig)
     exit(EXIT_FAILURE);
 }
 
+// SIGUSR1: pide un checkpoint, se guarda en el game loop con el estado bloqueado
+void checkpoint_handler(int sig)
+{
+    (void)sig;
+    checkpoint_requested = 1;
+}
+
 void parse_arguments(int argc, char *argv[], game_config_t *config) // parsea los argumentos y completa config
 {
     // Inicializar configuración por defecto
@@ -81,14 +155,47 @@ void parse_arguments(int argc, char *argv[], game_config_t *config) // parsea lo
     config->delay = DEFAULT_DELAY;
     config->timeout = DEFAULT_TIMEOUT;
     config->seed = time(NULL);
+    config->board_gen.rng = RNG_PHILOX;
+    config->board_gen.profile = REWARD_UNIFORM;
+    config->board_gen.threads = 0;
     config->view_path = NULL;
+    config->replay_path = NULL;
+    config->map_path = NULL;
+    config->save_map_path = NULL;
+    config->result_path = NULL;
+    config->shm_flags = 0;
+    config->inproc = false;
+    config->turn_mode = TURN_MODE_SEM;
+    config->sched_policy = SCHEDULER_RR;
+    for (int i = 0; i < MAX_PLAYERS; i++)
+        config->sched_weights[i] = 1;
     config->player_paths = NULL;
     config->player_count = 0;
 
+    static const struct option long_options[] =
+    {
+        {"replay", required_argument, NULL, 'r'},
+        {"rng", required_argument, NULL, OPT_RNG},
+        {"profile", required_argument, NULL, OPT_PROFILE},
+        {"gen-threads", required_argument, NULL, OPT_GEN_THREADS},
+        {"map", required_argument, NULL, OPT_MAP},
+        {"save-map", required_argument, NULL, OPT_SAVE_MAP},
+        {"ns", required_argument, NULL, OPT_NS},
+        {"result", required_argument, NULL, OPT_RESULT},
+        {"memfd", no_argument, NULL, OPT_MEMFD},
+        {"inproc", no_argument, NULL, OPT_INPROC},
+        {"futex", no_argument, NULL, OPT_FUTEX},
+        {"sched", required_argument, NULL, OPT_SCHED},
+        {"hugepages", no_argument, NULL, OPT_HUGEPAGES},
+        {"prefault", no_argument, NULL, OPT_PREFAULT},
+        {"mlock", no_argument, NULL, OPT_MLOCK},
+        {NULL, 0, NULL, 0}
+    };
+
     int opt;
     bool players_found = false;
 
-    while ((opt = getopt(argc, argv, "w:h:d:t:s:v:p:")) != -1)
+    while ((opt = getopt_long(argc, argv, "w:h:d:t:s:v:r:p:", long_options, NULL)) != -1)
     {
         switch (opt)
         {
@@ -120,6 +227,68 @@ void parse_arguments(int argc, char *argv[], game_config_t *config) // parsea lo
         case 'v':
             config->view_path = optarg;
             break;
+        case 'r':
+            config->replay_path = optarg;
+            break;
+        case OPT_RNG:
+            if (parse_rng_kind(optarg, &config->board_gen.rng) == -1)
+            {
+                fprintf(stderr, "Unknown RNG '%s' (philox, libc)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case OPT_PROFILE:
+            if (parse_reward_profile(optarg, &config->board_gen.profile) == -1)
+            {
+                fprintf(stderr, "Unknown reward profile '%s' (uniform, clustered, gradient)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case OPT_GEN_THREADS:
+            config->board_gen.threads = atoi(optarg);
+            break;
+        case OPT_MAP:
+            config->map_path = optarg;
+            break;
+        case OPT_SAVE_MAP:
+            config->save_map_path = optarg;
+            break;
+        case OPT_NS:
+            // Se exporta para que la vista y los jugadores abran los mismos objetos
+            if (!valid_shm_namespace(optarg) || setenv(SHM_NAMESPACE_ENV, optarg, 1) == -1)
+            {
+                fprintf(stderr, "Invalid namespace '%s'\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case OPT_RESULT:
+            config->result_path = optarg;
+            break;
+        case OPT_MEMFD:
+            config->shm_flags |= SHM_FLAG_MEMFD;
+            break;
+        case OPT_INPROC:
+            config->inproc = true;
+            break;
+        case OPT_FUTEX:
+            config->turn_mode = TURN_MODE_FUTEX;
+            break;
+        case OPT_SCHED:
+            if (scheduler_parse(optarg, &config->sched_policy, config->sched_weights) == -1)
+            {
+                fprintf(stderr, "Unknown scheduler '%s' (rr, fifo, wfq[:w0,w1,...])\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case OPT_HUGEPAGES:
+            config->shm_flags |= SHM_FLAG_HUGEPAGES;
+            break;
+        case OPT_PREFAULT:
+            config->shm_flags |= SHM_FLAG_PREFAULT;
+            break;
+        case OPT_MLOCK:
+            config->shm_flags |= SHM_FLAG_MLOCK;
+            break;
         case 'p':
             players_found = true;
             // Contar jugadores restantes
@@ -149,6 +318,8 @@ void parse_arguments(int argc, char *argv[], game_config_t *config) // parsea lo
         }
     }
 
+    config->board_gen.seed = config->seed;
+
     if (!players_found || config->player_count == 0)
     {
         fprintf(stderr, "At least one player is required\n");
@@ -157,274 +328,194 @@ void parse_arguments(int argc, char *argv[], game_config_t *config) // parsea lo
     }
 }
 
-void initialize_shared_memory(game_config_t *config)// Crea y mapea la memoria compartida para estado y sincronización
+// Arma el tablero: desde un archivo de mapa o generado a partir de la semilla
+void setup_board(game_config_t *config, map_file_t *map)
 {
-    size_t state_size = sizeof(game_state_t) + sizeof(int) * config->width * config->height;
-    //Calcula el tamaño real a mapear para game_state: estructura base + arreglo flexible board (width*height ints).
-
-    state_shm_fd = shm_open(GAME_STATE_SHM, O_CREAT | O_RDWR, 0666);
-    // Crea/abre objeto de memoria compartida POSIX para el estado con lectura/escritura.
-    if (state_shm_fd == -1)
-        error_exit("shm_open state");
-
-    if (ftruncate(state_shm_fd, state_size) == -1)
-        error_exit("ftruncate state");
-
-    game_state = mmap(NULL, state_size, PROT_READ | PROT_WRITE, MAP_SHARED, state_shm_fd, 0);
-    if (game_state == MAP_FAILED)
-        error_exit("mmap state");
-
-    // Crear memoria compartida para sincronización
-    sync_shm_fd = shm_open(GAME_SYNC_SHM, O_CREAT | O_RDWR, 0666);
-    if (sync_shm_fd == -1)
-        error_exit("shm_open sync");
-
-    if (ftruncate(sync_shm_fd, sizeof(game_sync_t)) == -1)
-        error_exit("ftruncate sync");
-
-    game_sync = mmap(NULL, sizeof(game_sync_t), PROT_READ | PROT_WRITE, MAP_SHARED, sync_shm_fd, 0);
-    if (game_sync == MAP_FAILED)
-        error_exit("mmap sync");
-
-    // Inicializar estado del juego
-    game_state->width = config->width;
-    game_state->height = config->height;
-    game_state->player_count = config->player_count;
-    game_state->game_finished = false;
-
-    // Inicializar semáforos
-    if (sem_init(&game_sync->view_notify, 1, 0) == -1)
-        error_exit("sem_init view_notify");
-    if (sem_init(&game_sync->view_done, 1, 0) == -1)
-        error_exit("sem_init view_done");
-    if (sem_init(&game_sync->master_access, 1, 1) == -1)
-        error_exit("sem_init master_access");
-    if (sem_init(&game_sync->state_mutex, 1, 1) == -1)
-        error_exit("sem_init state_mutex");
-    if (sem_init(&game_sync->reader_count_mutex, 1, 1) == -1)
-        error_exit("sem_init reader_count_mutex");
-    game_sync->reader_count = 0;
-
-    for (int i = 0; i < MAX_PLAYERS; i++)
+    if (!config->map_path)
     {
-        if (sem_init(&game_sync->player_can_move[i], 1, 1) == -1)
-            error_exit("sem_init player_can_move");
+        initialize_board(game_state, &config->board_gen);// Recorre tablero y asigna recompensas aleatorias
+        place_players(game_state);
+        return;
     }
+
+    map_load_board(map, game_state);
+    if (!map_restore_players(map, game_state))
+        place_players(game_state); // El mapa no es un checkpoint de esta partida
+    map_close(map);
 }
 
-void initialize_board(game_config_t *config)// Recorre tablero y asigna recompensas aleatorias
+void save_checkpoint(game_config_t *config)
 {
-    srand(config->seed);
-
-    // Llenar tablero con recompensas aleatorias
-    for (int y = 0; y < config->height; y++)
-    {
-        for (int x = 0; x < config->width; x++)
-        {
-            int reward = MIN_REWARD + rand() % MAX_REWARD;
-            set_board_cell(game_state, x, y, reward);
-        }
-    }
+    if (map_save(config->save_map_path, game_state, true) == -1)
+        perror("map_save");
 }
 
-void place_players(game_config_t *config) // Coloca jugadores en posiciones iniciales y pone datos iniciales en cada jugador
+void initialize_shared_memory(game_config_t *config)// Crea y mapea la memoria compartida para estado y sincronización
 {
-    // Distribución simple: colocar jugadores en esquinas y bordes
-    int positions[][2] = 
-    {
-        {0, 0}, {config->width - 1, 0}, {0, config->height - 1}, {config->width - 1, config->height - 1}, {config->width / 2, 0}, {config->width / 2, config->height - 1}, {0, config->height / 2}, {config->width - 1, config->height / 2}, {config->width / 2, config->height / 2}
-    };
+    if (create_shared_memory(config->width, config->height, config->player_count, config->shm_flags, &game_state, &game_sync) != 0)
+        error_exit("create_shared_memory");
+    turn_sync_init(game_sync, config->turn_mode, TURN_SPIN_DEFAULT);
+}
 
-    for (int i = 0; i < config->player_count; i++)
+// Lanza un hijo con posix_spawn: glibc usa clone(CLONE_VM | CLONE_VFORK), así que no se
+// duplican las tablas de páginas del máster (que ya tiene mapeado el estado completo)
+static pid_t spawn_child(const char *path, const char *width_str, const char *height_str, int stdout_fd)
+{
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return -1;
+    if (stdout_fd != INVALID_FD)
+        posix_spawn_file_actions_adddup2(&actions, stdout_fd, STDOUT_FILENO); // dup2 limpia O_CLOEXEC
+
+    char *const argv[] = {(char *)path, (char *)width_str, (char *)height_str, NULL};
+    pid_t pid;
+    int err = posix_spawn(&pid, path, &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (err != 0)
     {
-        snprintf(game_state->players[i].name, PLAYER_NAME_SIZE, "Player%d", i);
-        game_state->players[i].score = 0;
-        game_state->players[i].invalid_moves = 0;
-        game_state->players[i].valid_moves = 0;
-        game_state->players[i].x = positions[i][0];
-        game_state->players[i].y = positions[i][1];
-        game_state->players[i].blocked = false;
-
-        // Marcar celda como ocupada
-        set_board_cell(game_state, positions[i][0], positions[i][1], -i);
+        errno = err;
+        return -1;
     }
+    return pid;
+}
+
+// Falla al lanzar: los hijos ya creados esperan el lock, así que hay que terminarlos
+static void abort_startup(const char *msg, int spawned)
+{
+    int saved_errno = errno;
+    if (view_pid > 0)
+        kill(view_pid, SIGTERM);
+    for (int i = 0; i < spawned; i++)
+        kill(player_pids[i], SIGTERM);
+    cleanup_resources();
+    errno = saved_errno;
+    error_exit(msg);
 }
 
 void create_processes(game_config_t *config)
 {
+    char width_str[INT_STR_BUF], height_str[INT_STR_BUF];
+    snprintf(width_str, sizeof(width_str), "%d", config->width);
+    snprintf(height_str, sizeof(height_str), "%d", config->height);
+
     // view
     if (config->view_path)
     {
-        view_pid = fork();
+        view_pid = spawn_child(config->view_path, width_str, height_str, INVALID_FD);
         if (view_pid == -1)
-            error_exit("fork view");
-
-        if (view_pid == 0)
-        {
-            char width_str[16], height_str[16];
-            snprintf(width_str, sizeof(width_str), "%d", config->width);
-            snprintf(height_str, sizeof(height_str), "%d", config->height);
-
-            execl(config->view_path, config->view_path, width_str, height_str, NULL);
-            error_exit("execl view");
-        }
+            abort_startup("posix_spawn view", 0);
     }
 
+    if (config->inproc)
+        return; // Los jugadores son plugins ya cargados
+
     player_pids = malloc(config->player_count * sizeof(pid_t)); // almacena el pid de cada player
-    if (!player_pids)
-        error_exit("malloc player_pids");
-    player_pipes = malloc(config->player_count * sizeof(int *)); // almacena los pipes de cada player
-    if (!player_pipes)
-        error_exit("malloc player_pipes");
+    player_pipes = calloc(config->player_count, sizeof(int *)); // almacena los pipes de cada player
+    if (!player_pids || !player_pipes)
+        abort_startup("malloc player_pids", 0);
 
     // Crear pipes y procesos de jugadores
     for (int i = 0; i < config->player_count; i++)
     {
         player_pipes[i] = malloc(2 * sizeof(int));
         if (!player_pipes[i])
-        {
-            error_exit("malloc player_pipes[i]");
-        }
-        if (pipe(player_pipes[i]) == -1)
-        {
-            error_exit("pipe");
-        }
-
-        player_pids[i] = fork();
-        if (player_pids[i] == -1)
-            error_exit("fork player");
-
-        if (player_pids[i] == 0)
-        {
-            // Proceso hijo (jugador)
-            close(player_pipes[i][0]);               // Cerrar extremo de lectura
-            dup2(player_pipes[i][1], STDOUT_FILENO); // Redirigir stdout al pipe
-            close(player_pipes[i][1]);
+            abort_startup("malloc player_pipes[i]", i);
+        player_pipes[i][0] = player_pipes[i][1] = INVALID_FD;
+        // O_CLOEXEC: ningún jugador hereda los pipes de los demás
+        if (pipe2(player_pipes[i], O_CLOEXEC) == -1)
+            abort_startup("pipe2", i);
 
-            char width_str[16], height_str[16];
-            snprintf(width_str, sizeof(width_str), "%d", config->width);
-            snprintf(height_str, sizeof(height_str), "%d", config->height);
+        char id_str[INT_STR_BUF];
+        snprintf(id_str, sizeof(id_str), "%d", i);
+        setenv(PLAYER_ID_ENV, id_str, 1);
 
-            execl(config->player_paths[i], config->player_paths[i], width_str, height_str, NULL);
-            error_exit("execl player");
-        }
+        player_pids[i] = spawn_child(config->player_paths[i], width_str, height_str, player_pipes[i][1]);
+        if (player_pids[i] == -1)
+            abort_startup("posix_spawn player", i);
 
-        else
-        {
-            // Proceso padre
-            close(player_pipes[i][1]); // Cerrar extremo de escritura
-            player_pipes[i][1] = -1;   // Evita doble cierre en cleanup
-            game_state->players[i].pid = player_pids[i];
-        }
+        close(player_pipes[i][1]); // Cerrar extremo de escritura
+        player_pipes[i][1] = -1;   // Evita doble cierre en cleanup
+        PLAYER_PID(game_state, i) = player_pids[i];
     }
+    unsetenv(PLAYER_ID_ENV);
 }
 
-bool process_move(int player_id, unsigned char direction)
+// Toma state_mutex midiendo la espera y el tiempo dentro de la sección crítica
+void lock_state(void)
 {
-    if (player_id < 0 || (unsigned int)player_id >= game_state->player_count)
-        return false;
-
-    player_t *player = &game_state->players[player_id];
-    
-    if (player->blocked)
-        return false;
-
-    int dx, dy;
-    get_direction_offset(direction, &dx, &dy);
-
-    int new_x = player->x + dx;
-    int new_y = player->y + dy;
-
-    // Validar movimiento
-    if (!is_cell_free(game_state, new_x, new_y))
-    {
-        player->invalid_moves++;
-
-        // Después de un movimiento inválido, verificar si el jugador debe ser bloqueado
-        if (!player_has_valid_moves(game_state, player_id))
-            player->blocked = true;
-
-        return false;
-    }
-
-    // Movimiento válido
-    int reward = get_board_cell(game_state, new_x, new_y);
-    player->score += reward;
-    player->valid_moves++;
-
-    // Actualizar posición
-    player->x = new_x;
-    player->y = new_y;
-    set_board_cell(game_state, new_x, new_y, -player_id);
-
-    // Después de un movimiento válido, verificar si el jugador debe ser bloqueado
-    if (!player_has_valid_moves(game_state, player_id))
-        player->blocked = true;
-
-    return true;
+    uint64_t start = monotonic_ns();
+    TRACE_BEGIN("state_mutex_wait");
+    sem_wait(&game_sync->state_mutex);
+    TRACE_END("state_mutex_wait");
+    TRACE_BEGIN("state_mutex_hold");
+    state_locked_at = monotonic_ns();
+    STATS_ADD(game_stats, state_wait_ns, state_locked_at - start);
 }
 
-bool player_has_valid_moves(game_state_t *state, unsigned int player_id)
+void unlock_state(void)
 {
-    if (player_id >= state->player_count)
-        return false;
+    uint64_t now = monotonic_ns();
+    sem_post(&game_sync->state_mutex);
+    TRACE_END("state_mutex_hold");
+    STATS_ADD(game_stats, state_hold_ns, now - state_locked_at);
+    STATS_SET(game_stats, updated_ns, now);
+}
 
-    player_t *player = &state->players[player_id];
+// Habilita al jugador a enviar otro movimiento y arranca a medir su latencia de decisión
+void grant_turn(int player_id)
+{
+    turn_granted_at[player_id] = monotonic_ns();
+    turn_post(game_sync, player_id);
+}
 
-    // Verificar las 8 direcciones
-    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+void notify_view(void)
+{
+    if (view_pid > 0)
     {
-        int dx, dy;
-        get_direction_offset(dir, &dx, &dy);
-
-        int new_x = player->x + dx;
-        int new_y = player->y + dy;
-
-        if (is_cell_free(state, new_x, new_y))
-        {
-            return true; // Encontró al menos un movimiento válido
-        }
+        uint64_t start = monotonic_ns();
+        TRACE_BEGIN("notify_view");
+        CHOMP_PROBE0(view_frame_start);
+        turn_post(game_sync, TURN_SLOT_VIEW_NOTIFY);
+        turn_wait(game_sync, TURN_SLOT_VIEW_DONE);
+        CHOMP_PROBE0(view_frame_end);
+        TRACE_END("notify_view");
+        STATS_ADD(game_stats, notify_calls, 1);
+        STATS_ADD(game_stats, notify_view_ns, monotonic_ns() - start);
     }
-
-    return false; // No tiene movimientos válidos
 }
 
-bool check_game_end(void)
+void open_replay(game_config_t *config)
 {
-    // Verificar si algún jugador puede moverse
-    for (unsigned int i = 0; i < game_state->player_count; i++)
-    {
-        if (game_state->players[i].blocked)
-            continue;
+    if (!config->replay_path)
+        return;
 
-        player_t *player = &game_state->players[i];
-
-        // Verificar las 8 direcciones
-        for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
-        {
-            int dx, dy;
-            get_direction_offset(dir, &dx, &dy);
-
-            int new_x = player->x + dx;
-            int new_y = player->y + dy;
+    replay_header_t header;
+    replay_fill_header(&header, game_state, &config->board_gen, config->map_path != NULL);
+    if (replay_writer_open(&replay_writer, config->replay_path, &header) == -1)
+        error_exit("replay open");
+}
 
-            if (is_cell_free(game_state, new_x, new_y))
-            {
-                return false; // Al menos un jugador puede moverse
-            }
-        }
-    }
+// Registra un evento en el replay (solo escribe en el buffer en memoria)
+void record_move(int player_id, unsigned char move, unsigned char flags)
+{
+    if (replay_writer.fd == INVALID_FD)
+        return;
 
-    return true; // Ningún jugador puede moverse
+    replay_record_t record = {.player = player_id, .direction = move, .flags = flags};
+    if (replay_writer_append(&replay_writer, &record) == -1)
+        error_exit("replay write");
 }
 
-void notify_view(void)
+// Copia al segmento de estadísticas lo que midió el scheduler: la espera del que se acaba
+// de atender y el peor salteo de todos (los que siguen en la cola acaban de sumar uno)
+void publish_scheduler_stats(game_config_t *config, int served)
 {
-    if (view_pid > 0)
-    {
-        sem_post(&game_sync->view_notify);
-        sem_wait(&game_sync->view_done);
-    }
+    const scheduler_player_stats_t *st = &scheduler.stats[served];
+    STATS_SET(game_stats, sched_served[served], st->served);
+    STATS_SET(game_stats, sched_wait_sum_ns[served], st->wait_sum_ns);
+    STATS_SET(game_stats, sched_wait_max_ns[served], st->wait_max_ns);
+    for (int i = 0; i < config->player_count; i++)
+        STATS_SET(game_stats, sched_max_bypass[i], scheduler.stats[i].max_bypass);
 }
 
 void game_loop(game_config_t *config)
@@ -433,7 +524,6 @@ void game_loop(game_config_t *config)
     struct timeval timeout;
     int max_fd = 0;
     time_t last_valid_move = time(NULL);
-    int current_player = 0;
 
 
     // Encontrar el descriptor más alto para select
@@ -445,60 +535,81 @@ void game_loop(game_config_t *config)
         }
     }
 
+    // Los que ya arrancan bloqueados (checkpoint cargado con --map) no entran nunca a la cola
+    scheduler_init(&scheduler, config->sched_policy, config->player_count, config->sched_weights);
+    STATS_SET(game_stats, sched_policy, config->sched_policy);
+    lock_state();
+    for (int i = 0; i < config->player_count; i++)
+    {
+        if (PLAYER_BLOCKED(game_state, i))
+            scheduler_remove(&scheduler, i);
+    }
+    unlock_state();
+
+    // Los semáforos de turno arrancan en 1: todos los jugadores están habilitados desde ya
+    uint64_t loop_start = monotonic_ns();
+    for (int i = 0; i < config->player_count; i++)
+        turn_granted_at[i] = loop_start;
+
     notify_view(); // Mostrar estado inicial
 
     bool game_finished = false;
     while (!game_finished)
     {
-        // Leer estado del juego con protección
-        sem_wait(&game_sync->state_mutex);
-        game_finished = game_state->game_finished;
-        sem_post(&game_sync->state_mutex);
-        
-        //Limpia el conjunto de FDs y flag para saber si hay jugadores no bloqueados
-        FD_ZERO(&readfds); 
-        bool has_active_players = false;
-
-        // Agregar pipes de jugadores activos al set (con protección) NO ENTIENDO
-        sem_wait(&game_sync->state_mutex);
-        for (int i = 0; i < config->player_count; i++)
+        if (checkpoint_requested)
         {
-            if (!game_state->players[i].blocked)
-            {
-                FD_SET(player_pipes[i][0], &readfds);
-                has_active_players = true;
-            }
+            checkpoint_requested = 0;
+            lock_state();
+            save_checkpoint(config);
+            unlock_state();
         }
-        sem_post(&game_sync->state_mutex);
-
-        // Verificar condiciones de fin del juego con protección
-        bool should_end = false;
 
-        if (!has_active_players)
-            should_end = true;
+        // Leer estado del juego con protección
+        lock_state();
+        game_finished = game_state->game_finished;
+        unlock_state();
 
-        else
+        // Fin del juego: no queda nadie activo en la cola o nadie tiene movimientos
+        bool should_end = scheduler.active_mask == 0;
+        if (!should_end)
         {
-            // Proteger el acceso para check_game_end()
-            sem_wait(&game_sync->state_mutex);
-            should_end = check_game_end();
-            sem_post(&game_sync->state_mutex);
+            // Proteger el acceso para game_over()
+            lock_state();
+            should_end = game_rules->game_over(game_state);
+            unlock_state();
         }
 
         //marca fin del juego en memoria compartida si se cumple alguna condicion
         if (should_end)
         {
-            sem_wait(&game_sync->state_mutex);
+            lock_state();
             game_state->game_finished = true;
-            sem_post(&game_sync->state_mutex);
+            unlock_state();
             break;
         }
 
-        timeout.tv_sec = SELECT_TIMEOUT_SECONDS;
+        // select solo mira a los activos que todavía no tienen un movimiento en la cola. Si
+        // la cola no está vacía no se bloquea: solo levanta a los que llegaron mientras tanto
+        FD_ZERO(&readfds);
+        for (int i = 0; i < config->player_count; i++)
+        {
+            if (scheduler_is_active(&scheduler, i) && !scheduler_is_ready(&scheduler, i))
+                FD_SET(player_pipes[i][0], &readfds);
+        }
+        timeout.tv_sec = scheduler.ready_mask ? 0 : SELECT_TIMEOUT_SECONDS;
         timeout.tv_usec = 0;
 
         //espera a que haya actividad en los pipes de los jugadores
+        uint64_t select_start = monotonic_ns();
+        TRACE_BEGIN("select");
         int ready = select(max_fd + 1, &readfds, NULL, NULL, &timeout);
+        TRACE_END("select");
+        uint64_t select_end = monotonic_ns();
+        uint64_t select_time = select_end - select_start;
+        STATS_ADD(game_stats, select_calls, 1);
+        STATS_ADD(game_stats, select_ns, select_time);
+        if (ready == 0 && !scheduler.ready_mask)
+            STATS_ADD(game_stats, idle_ns, select_time);
 
         if (ready == -1)
         {
@@ -508,128 +619,294 @@ void game_loop(game_config_t *config)
             error_exit("select");
         }
 
+        for (int i = 0; i < config->player_count && ready > 0; i++)
+        {
+            if (FD_ISSET(player_pipes[i][0], &readfds))
+                scheduler_mark_ready(&scheduler, i, select_end);
+        }
+
         // Verificar timeout global de inactividad
         if (time(NULL) - last_valid_move > config->timeout)
         {
             // Proteger escritura del flag de fin de juego
-            sem_wait(&game_sync->state_mutex);
+            lock_state();
             game_state->game_finished = true;
-            sem_post(&game_sync->state_mutex);
+            unlock_state();
             break;
         }
 
-        // Procesar movimientos en round-robin
-        bool processed_move = false;
-        int starting_player = current_player; // Recordar desde dónde empezamos
-
-        for (int attempts = 0; attempts < config->player_count && !processed_move; attempts++)
+        // Un movimiento por vuelta: el jugador atendido vuelve a la cola en cuanto conteste,
+        // así la política decide también entre él y los que ya estaban esperando
+        int player_id = scheduler_next(&scheduler, monotonic_ns());
+        if (player_id == -1)
+            continue;
+        publish_scheduler_stats(config, player_id);
+
+        unsigned char move;
+        //Lee direccion (1 byte)
+        TRACE_BEGIN("read");
+        ssize_t bytes_read = read(player_pipes[player_id][0], &move, 1);
+        TRACE_END("read");
+        if (bytes_read == 1)
         {
-            int player_id = (current_player + attempts) % config->player_count;
+            CHOMP_PROBE2(move_received, player_id, move);
+            if (!first_move_at)
+            {
+                first_move_at = monotonic_ns();
+                STATS_SET(game_stats, first_move_ns, first_move_at - master_start_ns);
+            }
+            stats_record_latency(game_stats, player_id, monotonic_ns() - turn_granted_at[player_id]);
+        }
 
-            // Verificar si el jugador está bloqueado con protección
-            sem_wait(&game_sync->state_mutex);
-            bool player_blocked = game_state->players[player_id].blocked;
-            sem_post(&game_sync->state_mutex);
+        if (bytes_read == 0)
+        {
+            // EOF - jugador bloqueado (con protección)
+
+            //Marcamos al player como bloqueado y lo sacamos de la cola
+            lock_state();
+            PLAYER_BLOCKED(game_state, player_id) = true;
+            unlock_state();
+            scheduler_remove(&scheduler, player_id);
+            CHOMP_PROBE1(player_blocked, player_id);
+            record_move(player_id, 0, REPLAY_FLAG_EOF);
+
+            //Cerramos
+            close(player_pipes[player_id][0]);
+            player_pipes[player_id][0] = -1; // para que no intente cerrarlo de nuevo en cleanup
+            continue;
+        }
 
-            //Si bloqueado o su pipe no tuvo datos listos según select, salta a siguiente.
-            if (player_blocked || !FD_ISSET(player_pipes[player_id][0], &readfds))
+        if (bytes_read == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            { // Si no hay datos disponibles, continuar
                 continue;
+            }
+            error_exit("read move");
+        }
 
-            unsigned char move;
-            //Lee direccion (1 byte)
-            ssize_t bytes_read = read(player_pipes[player_id][0], &move, 1);
+        // Procesar movimiento
+        TRACE_BEGIN("master_access_wait");
+        sem_wait(&game_sync->master_access);
+        TRACE_END("master_access_wait");
+        lock_state();
+
+        TRACE_BEGIN("process_move");
+        unsigned int score_before = PLAYER_SCORE(game_state, player_id);
+        bool valid_move = game_rules->process_move(game_state, player_id, move);
+        if (valid_move)
+            reward_index_consume(reward_index, PLAYER_X(game_state, player_id), PLAYER_Y(game_state, player_id),
+                                 PLAYER_SCORE(game_state, player_id) - score_before);
+        TRACE_END("process_move");
+        if (valid_move)
+        {
+            last_valid_move = time(NULL);
+        }
+        STATS_ADD(game_stats, moves_processed, 1);
+        if (!valid_move)
+            STATS_ADD(game_stats, invalid_moves, 1);
 
-            if (bytes_read == 0)
-            {
-                // EOF - jugador bloqueado (con protección)
+        // process_move marca el bloqueo: se lee acá, con el estado todavía tomado
+        bool player_still_blocked = PLAYER_BLOCKED(game_state, player_id);
+        unlock_state();
+        sem_post(&game_sync->master_access);
 
-                //Marcamos al player como bloqueado
-                sem_wait(&game_sync->state_mutex);
-                game_state->players[player_id].blocked = true;
-                sem_post(&game_sync->state_mutex);
+        record_move(player_id, move, valid_move ? REPLAY_FLAG_VALID : 0);
 
-                //Cerramos
-                close(player_pipes[player_id][0]);
-                player_pipes[player_id][0] = -1; // para que no intente cerrarlo de nuevo en cleanup
-                continue;
-            }
+        // Solo notificar al jugador que puede enviar otro movimiento si NO está bloqueado
+        if (player_still_blocked)
+            scheduler_remove(&scheduler, player_id);
+        else
+            grant_turn(player_id);
+
+        // Notificar a la vista
+        notify_view();
+        // Esperar delay
+        uint64_t sleep_start = monotonic_ns();
+        TRACE_BEGIN("sleep");
+        usleep(config->delay * US_TO_MS);
+        TRACE_END("sleep");
+        STATS_ADD(game_stats, sleep_ns, monotonic_ns() - sleep_start);
+    }
 
-            if (bytes_read == -1)
-            {
-                if (errno == EAGAIN || errno == EWOULDBLOCK)
-                { // Si no hay datos disponibles, continuar
-                    continue;
-                }
-                error_exit("read move");
-            }
+    // Cerrar pipes de lectura para que los jugadores reciban EOF
+    for (int i = 0; i < config->player_count; i++)
+    {
+        if (player_pipes[i][0] != -1)
+        {
+            close(player_pipes[i][0]);
+            player_pipes[i][0] = -1;
+        }
+    }
 
-            // Procesar movimiento
-            sem_wait(&game_sync->master_access);
-            sem_wait(&game_sync->state_mutex);
+    // Liberar semáforos para que los jugadores salgan de su bucle
+    for (int i = 0; i < config->player_count; i++)
+    {
+        turn_post(game_sync, i);
+    }
 
-            bool valid_move = process_move(player_id, move);
-            if (valid_move)
-            {
-                last_valid_move = time(NULL);
-            }
+    CHOMP_PROBE1(game_finished, find_winner(game_state));
+    notify_view();
+}
 
-            sem_post(&game_sync->state_mutex);
-            sem_post(&game_sync->master_access);
+// Modo --inproc: carga un plugin por jugador (el mismo .so puede repetirse)
+void load_strategies(game_config_t *config)
+{
+    strategies = calloc(config->player_count, sizeof(loaded_strategy_t));
+    if (!strategies)
+        error_exit("calloc strategies");
 
-            // Verificar si el jugador está bloqueado después del movimiento (con protección)
-            sem_wait(&game_sync->state_mutex);
-            bool player_still_blocked = game_state->players[player_id].blocked;
-            sem_post(&game_sync->state_mutex);
+    for (int i = 0; i < config->player_count; i++)
+    {
+        if (!strategy_resolve(config->player_paths[i], &strategies[i]))
+        {
+            cleanup_resources();
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Arma la partida sobre el estado compartido; el nombre del jugador pasa a ser el de su
+// estrategia (lo muestran la vista y el replay)
+void attach_inproc_game(game_config_t *config)
+{
+    const chomp_strategy_t *plugins[MAX_PLAYERS];
+    for (int i = 0; i < config->player_count; i++)
+    {
+        plugins[i] = strategies[i].strategy;
+        snprintf(PLAYER_NAME(game_state, i), PLAYER_NAME_SIZE, "%s", plugins[i]->name);
+    }
+    if (sim_game_attach(&inproc_game, game_state, plugins) == -1)
+    {
+        cleanup_resources();
+        error_exit("sim_game_attach");
+    }
+    inproc_game.index = reward_index; // sim_play_turn lo actualiza; lo libera cleanup_resources
+}
 
-            // Solo notificar al jugador que puede enviar otro movimiento si NO está bloqueado
-            if (!player_still_blocked)
-                sem_post(&game_sync->player_can_move[player_id]);
+// Game loop sin procesos de jugador: cada turno es un sim_play_turn sobre el tablero
+// compartido (la estrategia se llama directo, sin copia). El lock cubre decisión y
+// movimiento juntos porque la vista puede estar leyendo.
+void inproc_game_loop(game_config_t *config)
+{
+    time_t last_valid_move = time(NULL);
+
+    notify_view(); // Mostrar estado inicial
+
+    bool game_finished = false;
+    while (!game_finished)
+    {
+        if (checkpoint_requested)
+        {
+            checkpoint_requested = 0;
+            lock_state();
+            save_checkpoint(config);
+            unlock_state();
+        }
+
+        bool moved = false;
+        for (int player_id = 0; player_id < config->player_count && !game_finished; player_id++)
+        {
+            if (PLAYER_BLOCKED(game_state, player_id))
+                continue;
+
+            lock_state();
+            uint64_t decision_start = monotonic_ns();
+            CHOMP_PROBE1(decision_start, player_id);
+            unsigned char move;
+            // Marca el fin antes de notificar: la vista sale apenas ve el flag después de un
+            // frame, así que el último movimiento y el fin tienen que llegarle juntos
+            sim_turn_t turn = sim_play_turn(&inproc_game, player_id, &move);
+            CHOMP_PROBE2(decision_end, player_id, move);
+            uint64_t decided_at = monotonic_ns(); // La latencia incluye aplicar el movimiento
+            game_finished = game_state->game_finished;
+            unlock_state();
+
+            stats_record_latency(game_stats, player_id, decided_at - decision_start);
+            if (!first_move_at)
+            {
+                first_move_at = decided_at;
+                STATS_SET(game_stats, first_move_ns, first_move_at - master_start_ns);
+            }
+            if (turn == SIM_TURN_GAVE_UP) // Equivale al EOF del pipe de un jugador que se retira
+            {
+                if (game_finished)
+                    notify_view(); // Era el último que podía mover: la vista tiene que ver el fin
+                continue;
+            }
 
-            processed_move = true;
+            bool valid_move = turn == SIM_TURN_VALID;
+            STATS_ADD(game_stats, moves_processed, 1);
+            if (!valid_move)
+                STATS_ADD(game_stats, invalid_moves, 1);
 
+            if (valid_move)
+                last_valid_move = time(NULL);
+            record_move(player_id, move, valid_move ? REPLAY_FLAG_VALID : 0);
+            moved = true;
 
-            // Actualizar current_player para que la próxima ronda empiece desde el siguiente jugador
-            current_player = (player_id + 1) % config->player_count;
-            // Notificar a la vista
             notify_view();
-            // Esperar delay
-            usleep(config->delay * US_TO_MS);
+            if (config->delay > 0)
+            {
+                uint64_t sleep_start = monotonic_ns();
+                usleep(config->delay * US_TO_MS);
+                STATS_ADD(game_stats, sleep_ns, monotonic_ns() - sleep_start);
+            }
         }
 
-        // Si no se procesó ningún movimiento en esta ronda, avanzar current_player
-        // para evitar quedarse siempre en el mismo punto de partida
-        if (!processed_move)
-            current_player = (starting_player + 1) % config->player_count;
+        // Nadie pudo mover o venció el timeout: termina sin un movimiento que lo anuncie
+        if (!game_finished && (!moved || time(NULL) - last_valid_move > config->timeout))
+        {
+            lock_state();
+            game_state->game_finished = true;
+            unlock_state();
+            game_finished = true;
+            notify_view();
+        }
     }
 
-    // Cerrar pipes de lectura para que los jugadores reciban EOF
-    for (int i = 0; i < config->player_count; i++)
+    CHOMP_PROBE1(game_finished, find_winner(game_state));
+}
+
+// Resultado en texto plano para herramientas (p. ej. tournament):
+//   player <índice> <score> <válidos> <inválidos>
+//   winner <índice>
+void write_result(game_config_t *config)
+{
+    FILE *out = fopen(config->result_path, "w");
+    if (!out)
     {
-        if (player_pipes[i][0] != -1)
-        {
-            close(player_pipes[i][0]);
-            player_pipes[i][0] = -1;
-        }
+        perror("result fopen");
+        return;
     }
 
-    // Liberar semáforos para que los jugadores salgan de su bucle
     for (int i = 0; i < config->player_count; i++)
     {
-        sem_post(&game_sync->player_can_move[i]);
+        fprintf(out, "player %d %u %u %u\n", i, PLAYER_SCORE(game_state, i), PLAYER_VALID_MOVES(game_state, i),
+                PLAYER_INVALID_MOVES(game_state, i));
     }
+    fprintf(out, "winner %d\n", find_winner(game_state));
 
-    notify_view();
+    board_summary_t summary;
+    board_summarize(game_state, &summary);
+    fprintf(out, "board %lu %lu\n", (unsigned long)summary.free_cells, (unsigned long)summary.reward);
+
+    if (fclose(out) != 0)
+        perror("result fclose");
 }
 
 void wait_for_processes(game_config_t *config)  // Espera a que terminen los procesos hijos y muestra sus resultados
 {
     // Esperar jugadores
-    for (int i = 0; i < config->player_count; i++)
+    for (int i = 0; i < config->player_count && !player_pids; i++)
+        printf("Player %d (%s, Score: %u): in-process\n", i + 1, PLAYER_NAME(game_state, i), PLAYER_SCORE(game_state, i));
+
+    for (int i = 0; i < config->player_count && player_pids; i++)
     {
         int status;
         waitpid(player_pids[i], &status, 0);
 
-        printf("Player %d (PID %d, Score: %u): ", i + 1, player_pids[i], game_state->players[i].score);
+        printf("Player %d (PID %d, Score: %u): ", i + 1, player_pids[i], PLAYER_SCORE(game_state, i));
         if (WIFEXITED(status))
         {
             printf("exited with code %d\n", WEXITSTATUS(status));
@@ -671,6 +948,7 @@ void wait_for_processes(game_config_t *config)  // Espera a que terminen los pro
 int main(int argc, char *argv[])
 {
     game_config_t config;
+    master_start_ns = monotonic_ns();
 
     //Registrar en los manejadores de señal siginit y sigterm para limpieza
     signal(SIGINT, signal_handler);
@@ -678,16 +956,61 @@ int main(int argc, char *argv[])
 
     //Parseo de argumentos
     parse_arguments(argc, argv, &config);
+    trace_init("master");
     player_count = config.player_count;
+    shm_flags = config.shm_flags;
 
-    initialize_shared_memory(&config);
+    // Con un mapa las dimensiones salen del archivo
+    map_file_t map;
+    if (config.map_path)
+    {
+        if (map_open(&map, config.map_path) == -1)
+            error_exit("map_open");
+        config.width = map.header->width;
+        config.height = map.header->height;
+    }
 
-    initialize_board(&config);// Recorre tablero y asigna recompensas aleatorias
-    place_players(&config);
+    if (config.save_map_path)
+        signal(SIGUSR1, checkpoint_handler);
+    if (config.inproc)
+        load_strategies(&config);
 
+    initialize_shared_memory(&config);
+    game_stats = stats_create(config.player_count, config.shm_flags);
+    reward_index = reward_index_create(config.width, config.height, config.shm_flags);
+    if (!reward_index)
+        perror("reward_index_create"); // Se juega igual: las estrategias recorren el tablero
+
+    // Los hijos se lanzan con el estado bloqueado y el tablero se llena mientras cargan:
+    // su primer acceso al estado (o la búsqueda del id por pid) espera al unlock
+    lock_state();
     create_processes(&config);
-
-    game_loop(&config);
+    STATS_SET(game_stats, spawn_ns, monotonic_ns() - master_start_ns);
+    setup_board(&config, &map);
+    game_rules = rules_select(game_state->width, game_state->height);
+    if (reward_index)
+        reward_index_build(reward_index, game_state);
+    if (config.inproc)
+        attach_inproc_game(&config);
+    unlock_state();
+    STATS_SET(game_stats, setup_ns, monotonic_ns() - master_start_ns);
+    close_inherited_segments(); // Los hijos ya tienen su copia de los memfd
+
+    open_replay(&config);
+
+    if (config.inproc)
+        inproc_game_loop(&config);
+    else
+        game_loop(&config);
+    STATS_SET(game_stats, game_finished, 1);
+
+    if (config.save_map_path)
+        save_checkpoint(&config);
+    if (config.result_path)
+        write_result(&config);
+
+    if (first_move_at)
+        printf("Time to first move: %.3f ms\n", (double)(first_move_at - master_start_ns) / NS_PER_MS);
 
     wait_for_processes(&config);
 
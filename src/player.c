@@ -1,16 +1,24 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include "common.h"
+#include "turnsync.h"
+#include "strategy.h"
+#include "endgame.h"
+#include "trace.h"
+#include "probes.h"
 
 static game_state_t *game_state = NULL;
 static game_sync_t *game_sync = NULL;
 static int player_id = -1;
-// Para estrategia de un solo jugador
-// Estado single-player: recorrido de perímetros (clockwise) dynamic
-static int sp_initialized = 0;
-static int sp_finished = 0;
-static unsigned int sp_turn = 0;
-static unsigned char sp_dir = DIR_RIGHT; // dirección cardinal actual
+static loaded_strategy_t loaded;     // Estrategia elegida (incluida o plugin)
+static void *strategy_state = NULL; // Estado privado de la estrategia elegida
+static const reward_index_t *reward_index = NULL; // Índice del máster, si lo publica
+static endgame_t endgame;            // Camino planeado una vez aislado (endgame.h)
+static bool endgame_enabled = false;
+
+// Estrategia por entorno (greedy, perimeter, region o un plugin .so); sin definir se elige
+// según la partida
+#define PLAYER_STRATEGY_ENV "CHOMP_STRATEGY"
 
 /*
  desmapear (con munmap) las regiones de memoria que el proceso mapeó con mmap
@@ -18,6 +26,14 @@ static unsigned char sp_dir = DIR_RIGHT; // dirección cardinal actual
 void cleanup_player(void)
 {
     cleanup_shared_memory(game_state, game_sync);
+    reward_index_close(reward_index);
+    reward_index = NULL;
+    free(strategy_state);
+    strategy_state = NULL;
+    strategy_unload(&loaded);
+    endgame_destroy(&endgame);
+    poscache_close(endgame.cache);
+    endgame.cache = NULL;
     // limpear el pipe del mismo
     // nada dinámico ahora
 }
@@ -42,171 +58,28 @@ int find_player_id(void)
     pid_t my_pid = getpid();
 
     // Leer estado para encontrar nuestro ID
-    sem_wait(&game_sync->reader_count_mutex);
-    game_sync->reader_count++;
-    if (game_sync->reader_count == 1)
-    {
-        sem_wait(&game_sync->state_mutex);
-    }
-    sem_post(&game_sync->reader_count_mutex);
+    read_lock_state(game_sync);
 
     int id = -1;
     for (unsigned int i = 0; i < game_state->player_count; i++)
     {
-        if (game_state->players[i].pid == my_pid)
+        if (PLAYER_PID(game_state, i) == my_pid)
         {
             id = i;
             break;
         }
     }
 
-    sem_wait(&game_sync->reader_count_mutex);
-    game_sync->reader_count--;
-    if (game_sync->reader_count == 0)
-    {
-        sem_post(&game_sync->state_mutex);
-    }
-    sem_post(&game_sync->reader_count_mutex);
+    read_unlock_state(game_sync);
 
     return id;
 }
 
-// utilizo los valores locales guardados para decidir el movimiento
-// lo que se hace es buscar en todas las direcciones el mejor reward y me muevo hacia ahi (greedy)
-unsigned char choose_move_with_local_data(player_t *my_player, int *local_board, int board_width, int board_height)
-{
-    unsigned char best_move = 0;
-    int best_reward = -1;
-
-    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
-    {
-        int dx, dy;
-        get_direction_offset(dir, &dx, &dy);
-
-        int new_x = my_player->x + dx;
-        int new_y = my_player->y + dy;
-
-        // Validar límites usando datos locales
-        if (new_x < 0 || new_x >= board_width || new_y < 0 || new_y >= board_height)
-            continue;
-
-        // Obtener valor del tablero local
-        int cell_value = local_board[new_y * board_width + new_x];
-
-        // Verificar si la celda está libre (valor positivo = recompensa)
-        if (cell_value >= MIN_REWARD && cell_value <= MAX_REWARD)
-        {
-            if (cell_value > best_reward)
-            {
-                best_reward = cell_value;
-                best_move = dir;
-            }
-        }
-    }
-
-    return best_move;
-}
-
-static inline int sp_cell_free(int *local_board, int w, int h, int x, int y)
+const chomp_strategy_t *select_strategy(const char *name)
 {
-    if (x < 0 || x >= w || y < 0 || y >= h)
-        return 0;
-    int v = local_board[y * w + x];
-    return (v >= MIN_REWARD && v <= MAX_REWARD);
-}
-
-static int sp_can_move_dir(int *local_board, int w, int h, int x, int y, unsigned char dir)
-{
-    int dx, dy;
-    get_direction_offset(dir, &dx, &dy);
-    return sp_cell_free(local_board, w, h, x + dx, y + dy);
-}
-
-static unsigned char sp_turn_left(unsigned char d)
-{
-    switch (d)
-    {
-    case DIR_UP:
-        return DIR_LEFT;
-    case DIR_LEFT:
-        return DIR_DOWN;
-    case DIR_DOWN:
-        return DIR_RIGHT;
-    default:
-        return DIR_UP; // DIR_RIGHT
-    }
-}
-static unsigned char sp_turn_right(unsigned char d)
-{
-    switch (d)
-    {
-    case DIR_UP:
-        return DIR_RIGHT;
-    case DIR_RIGHT:
-        return DIR_DOWN;
-    case DIR_DOWN:
-        return DIR_LEFT;
-    default:
-        return DIR_UP; // DIR_LEFT
-    }
-}
-
-static unsigned char choose_move_single_player_perimeter(player_t *my_player, int *local_board, int w, int h)
-{
-    int x = my_player->x, y = my_player->y;
-
-    if (!sp_initialized)
-    {
-        sp_initialized = 1;
-        sp_dir = DIR_RIGHT;
-        sp_turn = 0;
-        sp_finished = 0;
-        fprintf(stderr, "[WALL] init (%d,%d)\n", x, y);
-    }
-
-    if (sp_finished)
-        return DIR_RIGHT;
-
-    // mantener mano izquierda en pared: girar izquierda si se puede; luego recto; luego derecha; luego 180.
-
-    //intento girar izquierda
-    unsigned char left = sp_turn_left(sp_dir);
-    if (sp_can_move_dir(local_board, w, h, x, y, left))
-    {
-        sp_dir = left;
-        sp_turn++;
-        return sp_dir;
-    }
-
-    // intento seguir recto
-    if (sp_can_move_dir(local_board, w, h, x, y, sp_dir))
-    {
-        sp_turn++;
-        return sp_dir;
-    }
-
-    // intento girar derecha
-    unsigned char right = sp_turn_right(sp_dir);
-    if (sp_can_move_dir(local_board, w, h, x, y, right))
-    {
-        sp_dir = right;
-        sp_turn++;
-        return sp_dir;
-    }
-
-    // intento dar vuelta
-    unsigned char back = sp_turn_right(sp_turn_right(sp_dir));
-    if (sp_can_move_dir(local_board, w, h, x, y, back))
-    {
-        sp_dir = back;
-        sp_turn++;
-        return sp_dir;
-    }
-    
-    // ninguna libre -> terminado
-    sp_finished = 1;
-    fprintf(stderr, "[WALL] finished (%d,%d) turns=%u\n", x, y, sp_turn);
-    return DIR_RIGHT;
+    if (!name || !*name)
+        name = game_state->player_count == 1 ? perimeter_strategy.name : greedy_strategy.name;
+    return strategy_resolve(name, &loaded);
 }
 
 int main(int argc, char *argv[])
@@ -231,9 +104,12 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    trace_init("player");
     connect_shared_memory_player(width, height);
-    // Encontrar nuestro ID de jugador
-    player_id = find_player_id();
+    // Encontrar nuestro ID de jugador: el máster lo pasa por entorno, si no se busca por pid
+    player_id = player_id_from_env(game_state);
+    if (player_id == -1)
+        player_id = find_player_id();
     if (player_id == -1)
     {
         fprintf(stderr, "Could not find player ID\n");
@@ -241,55 +117,88 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    // estrategia de un solo jugador mano izquierda en pared; con más jugadores, greedy
+    const chomp_strategy_t *strategy = select_strategy(getenv(PLAYER_STRATEGY_ENV));
+    if (!strategy)
+    {
+        fprintf(stderr, "Unknown strategy '%s' (greedy, perimeter, region or plugin .so)\n", getenv(PLAYER_STRATEGY_ENV));
+        cleanup_player();
+        return EXIT_FAILURE;
+    }
+    reward_index = reward_index_open_readonly(width, height);
+    if (strategy->state_size)
+    {
+        strategy_state = calloc(1, strategy->state_size);
+        if (!strategy_state)
+        {
+            cleanup_player();
+            error_exit("calloc strategy_state");
+        }
+    }
+
+    long endgame_limit_ms = endgame_limit_from_env();
+    endgame_enabled = endgame_limit_ms >= 0;
+    endgame_init(&endgame, endgame_enabled ? (uint64_t)endgame_limit_ms * NS_PER_MS : 0);
+    if (endgame_enabled)
+        endgame.cache = poscache_open_from_env();
+
     while (true)
     {
         // Esperar permiso para moverse
-        sem_wait(&game_sync->player_can_move[player_id]);
+        TRACE_BEGIN("wait_turn");
+        turn_wait(game_sync, player_id);
+        TRACE_END("wait_turn");
 
-        sem_wait(&game_sync->reader_count_mutex);
-        game_sync->reader_count++;
-        if (game_sync->reader_count == 1)
-        {
-            sem_wait(&game_sync->state_mutex);
-        }
-        sem_post(&game_sync->reader_count_mutex);
+        TRACE_BEGIN("copy_state");
+        read_lock_state(game_sync);
 
         // Copia todo el estado necesario en variables locales
         bool game_finished = game_state->game_finished;
-        bool blocked = game_state->players[player_id].blocked;
+        bool blocked = PLAYER_BLOCKED(game_state, player_id);
 
         // Copiar datos del jugador actual
-        player_t my_player = game_state->players[player_id];
+        player_t my_player;
+        get_player(game_state, player_id, &my_player);
+
+        // El final necesita las cabezas de los rivales para saber si estamos aislados
+        player_t players[MAX_PLAYERS];
+        unsigned int player_count = game_state->player_count;
+        if (endgame_enabled)
+        {
+            for (unsigned int i = 0; i < player_count && i < MAX_PLAYERS; i++)
+                get_player(game_state, i, &players[i]);
+        }
 
         // Copiar tablero a buffer local (solo lo necesario)
-        int local_board[game_state->width * game_state->height];
-        memcpy(local_board, game_state->board, sizeof(int) * game_state->width * game_state->height);
+        size_t cells = BOARD_CELLS(game_state->width, game_state->height);
+        int local_board[cells];
+        memcpy(local_board, game_state->board, sizeof(int) * cells);
 
         // Copiar dimensiones
         int board_width = game_state->width;
         int board_height = game_state->height;
 
         // Termino de leer
-        sem_wait(&game_sync->reader_count_mutex);
-        game_sync->reader_count--;
-        if (game_sync->reader_count == 0)// si es el ultimo libero el mutex 
-        {
-            sem_post(&game_sync->state_mutex);
-        }
-        sem_post(&game_sync->reader_count_mutex);
+        read_unlock_state(game_sync);
+        TRACE_END("copy_state");
 
         unsigned char move = 0;
+        TRACE_BEGIN("strategy");
+        CHOMP_PROBE1(decision_start, player_id);
         if (!game_finished && !blocked)
         {
-            if (game_state->player_count == 1)
-            {
-                // estrategia de un solo jugador mano izquierda en pared 
-                move = choose_move_single_player_perimeter(&my_player, local_board, board_width, board_height);
-                if (sp_finished)
-                    break;
-            }
-            else
-                move = choose_move_with_local_data(&my_player, local_board, board_width, board_height);
+            board_view_t board = {local_board, board_width, board_height, player_count, reward_index};
+            if (!endgame_enabled || !endgame_next_move(&endgame, &board, player_id, players, &move))
+                move = strategy->choose(&board, &my_player, strategy_state);
+        }
+        CHOMP_PROBE2(decision_end, player_id, move);
+        TRACE_END("strategy");
+
+        // la estrategia no tiene más movimientos (p. ej. terminó el perímetro)
+        if (move == STRATEGY_NO_MOVE)
+        {
+            fprintf(stderr, "[%s] finished (%d,%d)\n", strategy->name, my_player.x, my_player.y);
+            break;
         }
 
         //verifico si se bloqueo en la eleccion del movimiento
@@ -301,6 +210,10 @@ int main(int argc, char *argv[])
             break; // Error o pipe cerrado
     }
 
+    const char *endgame_stats = getenv(ENDGAME_STATS_ENV);
+    if (endgame_stats && strcmp(endgame_stats, "1") == 0 && (endgame.plans || endgame.cache_hits))
+        fprintf(stderr, "[endgame] %lu plans (%lu exact, %lu timed out), %lu from cache, planned reward %lu\n",
+                endgame.plans, endgame.exact_plans, endgame.timeouts, endgame.cache_hits, endgame.planned_reward);
     cleanup_player();
     return 0;
 }
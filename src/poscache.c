@@ -0,0 +1,154 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "poscache.h"
+#include <sys/file.h>
+
+static size_t poscache_size(void)
+{
+    return sizeof(poscache_header_t) + sizeof(poscache_slot_t) * POSCACHE_SLOTS + POSCACHE_ARENA_BYTES;
+}
+
+poscache_t *poscache_open(const char *path)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, SHM_PERMISSIONS);
+    if (fd == -1)
+    {
+        perror("poscache open");
+        return NULL;
+    }
+
+    // El primero que llega lo dimensiona e inicializa; el resto espera el flock
+    size_t size = poscache_size();
+    struct stat st;
+    if (flock(fd, LOCK_EX) == -1 || fstat(fd, &st) == -1 ||
+        (st.st_size == 0 && ftruncate(fd, (off_t)size) == -1))
+    {
+        perror("poscache init");
+        close(fd);
+        return NULL;
+    }
+    if (st.st_size != 0 && (size_t)st.st_size != size)
+    {
+        fprintf(stderr, "poscache: %s has an unexpected size, ignoring it\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        perror("poscache mmap");
+        close(fd);
+        return NULL;
+    }
+    poscache_header_t *header = map;
+    if (header->magic == 0)
+    {
+        header->version = POSCACHE_VERSION;
+        header->slot_count = POSCACHE_SLOTS;
+        header->arena_bytes = POSCACHE_ARENA_BYTES;
+        __atomic_store_n(&header->magic, POSCACHE_MAGIC, __ATOMIC_RELEASE);
+    }
+    flock(fd, LOCK_UN);
+    close(fd); // El mapeo sigue vivo sin el descriptor
+
+    if (header->magic != POSCACHE_MAGIC || header->version != POSCACHE_VERSION ||
+        header->slot_count != POSCACHE_SLOTS || header->arena_bytes != POSCACHE_ARENA_BYTES)
+    {
+        fprintf(stderr, "poscache: %s was created by another version, ignoring it\n", path);
+        munmap(map, size);
+        return NULL;
+    }
+
+    poscache_t *cache = malloc(sizeof(poscache_t));
+    if (!cache)
+    {
+        munmap(map, size);
+        return NULL;
+    }
+    cache->header = header;
+    cache->slots = (poscache_slot_t *)(header + 1);
+    cache->arena = (unsigned char *)(cache->slots + POSCACHE_SLOTS);
+    cache->map_size = size;
+    return cache;
+}
+
+poscache_t *poscache_open_from_env(void)
+{
+    const char *path = getenv(POSCACHE_ENV);
+    return path && *path ? poscache_open(path) : NULL;
+}
+
+void poscache_close(poscache_t *cache)
+{
+    if (!cache)
+        return;
+    munmap(cache->header, cache->map_size);
+    free(cache);
+}
+
+static void count(uint64_t *counter)
+{
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
+
+size_t poscache_lookup(poscache_t *cache, poscache_key_t key, unsigned char *out, size_t capacity)
+{
+    for (uint32_t probe = 0; probe < POSCACHE_MAX_PROBES; probe++)
+    {
+        poscache_slot_t *slot = &cache->slots[(key.hi + probe) & (POSCACHE_SLOTS - 1)];
+        uint64_t hi = __atomic_load_n(&slot->key_hi, __ATOMIC_ACQUIRE);
+        if (hi == 0)
+            break; // Nadie insertó más allá: no está
+        if (hi != key.hi)
+            continue;
+        uint32_t length = __atomic_load_n(&slot->length, __ATOMIC_ACQUIRE);
+        if (length == 0 || slot->key_lo != key.lo) // A medio escribir, o colisión de hi
+            continue;
+        if (length > capacity)
+            break;
+        memcpy(out, cache->arena + slot->offset, length);
+        count(&cache->header->hits);
+        return length;
+    }
+    count(&cache->header->misses);
+    return 0;
+}
+
+int poscache_insert(poscache_t *cache, poscache_key_t key, const unsigned char *value, size_t length)
+{
+    if (length == 0 || length > POSCACHE_ARENA_BYTES)
+        return -1;
+
+    // Primero la arena: si no hay lugar no se reclama ningún slot
+    uint64_t offset = __atomic_fetch_add(&cache->header->arena_used, length, __ATOMIC_RELAXED);
+    if (offset + length > POSCACHE_ARENA_BYTES)
+    {
+        count(&cache->header->failed_inserts);
+        return -1;
+    }
+    memcpy(cache->arena + offset, value, length);
+
+    for (uint32_t probe = 0; probe < POSCACHE_MAX_PROBES; probe++)
+    {
+        poscache_slot_t *slot = &cache->slots[(key.hi + probe) & (POSCACHE_SLOTS - 1)];
+        uint64_t expected = 0;
+        if (!__atomic_compare_exchange_n(&slot->key_hi, &expected, key.hi, false, __ATOMIC_ACQ_REL,
+                                         __ATOMIC_ACQUIRE))
+        {
+            // Ocupado: si es la misma clave ya publicada no hay nada que hacer (la arena
+            // reservada se pierde, es una carrera rara)
+            if (expected == key.hi && __atomic_load_n(&slot->length, __ATOMIC_ACQUIRE) != 0 &&
+                slot->key_lo == key.lo)
+                return 0;
+            continue;
+        }
+        slot->key_lo = key.lo;
+        slot->offset = (uint32_t)offset;
+        __atomic_store_n(&slot->length, (uint32_t)length, __ATOMIC_RELEASE);
+        count(&cache->header->entries);
+        return 0;
+    }
+    count(&cache->header->failed_inserts);
+    return -1;
+}
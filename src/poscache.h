@@ -0,0 +1,68 @@
+#ifndef POSCACHE_H
+#define POSCACHE_H
+
+#include "common.h"
+
+// Caché de posiciones persistente: una tabla hash de direccionamiento abierto en un archivo
+// mapeado con MAP_SHARED, compartida por todos los procesos (y los hilos de simulate) que
+// abran la misma ruta. Sobrevive entre partidas: con los mismos seeds y tableros chicos,
+// la segunda vez la búsqueda ya está hecha.
+// La clave la arma quien busca (endgame.c: la bolsa canónica) y el valor es una secuencia
+// de movimientos guardada en una arena de solo agregar. Las inserciones no toman locks:
+// se reserva la arena con fetch_add, se reclama el slot con CAS sobre key_hi y se publica
+// con un store release de length; un lector solo usa slots publicados.
+// La tabla no se achica ni se reemplazan entradas: llena, las inserciones fallan.
+#define POSCACHE_ENV "CHOMP_POSCACHE" // Ruta del archivo; sin definir no hay caché
+#define POSCACHE_MAGIC 0x43504f53u    // "CPOS"
+#define POSCACHE_VERSION 1
+#define POSCACHE_SLOTS (1u << 16)     // Potencia de 2
+#define POSCACHE_ARENA_BYTES (32u << 20)
+#define POSCACHE_MAX_PROBES 32
+
+typedef struct
+{
+    uint64_t hi; // Nunca 0 (0 marca un slot libre)
+    uint64_t lo;
+} poscache_key_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t arena_bytes;
+    uint64_t arena_used; // Atómico: bump allocator de la arena
+    uint64_t entries;    // Contadores atómicos, solo informativos
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t failed_inserts;
+} poscache_header_t;
+
+typedef struct
+{
+    uint64_t key_hi; // CAS 0 -> clave para reclamar el slot
+    uint64_t key_lo;
+    uint32_t offset; // En la arena
+    uint32_t length; // 0 mientras se escribe; se publica con release
+} poscache_slot_t;
+
+typedef struct
+{
+    poscache_header_t *header;
+    poscache_slot_t *slots;
+    unsigned char *arena;
+    size_t map_size;
+} poscache_t;
+
+// Crea el archivo si no existe (el primero lo inicializa bajo flock). NULL si no se pudo
+// abrir o si el archivo es de otra versión.
+poscache_t *poscache_open(const char *path);
+// POSCACHE_ENV, o NULL si no está definida
+poscache_t *poscache_open_from_env(void);
+void poscache_close(poscache_t *cache);
+// Copia en out (hasta capacity bytes) el valor de key y devuelve su largo; 0 si no está
+size_t poscache_lookup(poscache_t *cache, poscache_key_t key, unsigned char *out, size_t capacity);
+// -1 si no hay lugar (arena llena o POSCACHE_MAX_PROBES slots ocupados); 0 también si ya estaba
+int poscache_insert(poscache_t *cache, poscache_key_t key, const unsigned char *value, size_t length);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef PROBES_H
+#define PROBES_H
+
+// Tracepoints estáticos USDT (provider "chompchamps") para perf/bpftrace/systemtap:
+//   bpftrace -e 'usdt:./master:chompchamps:move_applied { @[arg2] = count(); }' -p <pid>
+// Con <sys/sdt.h> (paquete systemtap-sdt-dev) cada probe es un nop más una nota ELF:
+// sin nadie enganchado no hay costo. Sin el header (o con -DCHOMP_NO_SDT) no generan código.
+#if !defined(CHOMP_NO_SDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define CHOMP_HAVE_SDT 1
+#endif
+#endif
+
+#ifdef CHOMP_HAVE_SDT
+#define CHOMP_PROBE0(name) DTRACE_PROBE(chompchamps, name)
+#define CHOMP_PROBE1(name, a) DTRACE_PROBE1(chompchamps, name, a)
+#define CHOMP_PROBE2(name, a, b) DTRACE_PROBE2(chompchamps, name, a, b)
+#define CHOMP_PROBE4(name, a, b, c, d) DTRACE_PROBE4(chompchamps, name, a, b, c, d)
+#else
+#define CHOMP_PROBE0(name) \
+    do                     \
+    {                      \
+    } while (0)
+#define CHOMP_PROBE1(name, a) \
+    do                        \
+    {                         \
+    } while (0)
+#define CHOMP_PROBE2(name, a, b) \
+    do                           \
+    {                            \
+    } while (0)
+#define CHOMP_PROBE4(name, a, b, c, d) \
+    do                                 \
+    {                                  \
+    } while (0)
+#endif
+
+// Probes disponibles:
+//   move_received(player, direction)             master, al leer un byte del pipe
+//   move_applied(player, direction, valid, reward) process_move
+//   player_blocked(player)                       process_move / EOF del pipe en el game loop
+//   view_frame_start() / view_frame_end()        notify_view del máster
+//   game_finished(winner)                        fin del game loop
+//   decision_start(player) / decision_end(player, move) loop principal del player
+
+#endif
@@ -0,0 +1,76 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "proxy_proto.h"
+#include <sys/socket.h>
+
+// Header y payload en un solo sendmsg: el motor nunca ve un header sin su payload a medias
+int proxy_send(int fd, uint8_t type, uint8_t flags, uint32_t seq, const void *payload, uint32_t length)
+{
+    proxy_msg_header_t header = {type, flags, PROXY_PROTO_VERSION, seq, length};
+    struct iovec iov[2] = {{&header, sizeof(header)}, {(void *)payload, length}};
+    struct msghdr msg = {.msg_iov = iov, .msg_iovlen = length ? 2 : 1};
+
+    size_t total = sizeof(header) + length;
+    size_t sent = 0;
+    while (sent < total)
+    {
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        sent += n;
+        // Envío parcial (mensajes grandes, como el INIT): avanzar los iovec
+        while (n > 0 && msg.msg_iovlen > 0)
+        {
+            size_t chunk = (size_t)n < msg.msg_iov->iov_len ? (size_t)n : msg.msg_iov->iov_len;
+            msg.msg_iov->iov_base = (char *)msg.msg_iov->iov_base + chunk;
+            msg.msg_iov->iov_len -= chunk;
+            n -= chunk;
+            if (msg.msg_iov->iov_len == 0)
+            {
+                msg.msg_iov++;
+                msg.msg_iovlen--;
+            }
+        }
+    }
+    return 0;
+}
+
+static int read_exact(int fd, void *data, size_t size)
+{
+    size_t done = 0;
+    while (done < size)
+    {
+        ssize_t n = read(fd, (char *)data + done, size - done);
+        if (n == 0)
+            return -1; // El otro extremo cerró
+        if (n == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        done += n;
+    }
+    return 0;
+}
+
+int proxy_recv_header(int fd, proxy_msg_header_t *header)
+{
+    if (read_exact(fd, header, sizeof(*header)) == -1)
+        return -1;
+    if (header->version != PROXY_PROTO_VERSION)
+    {
+        errno = EPROTO;
+        return -1;
+    }
+    return 0;
+}
+
+int proxy_recv_payload(int fd, void *payload, uint32_t length)
+{
+    return length ? read_exact(fd, payload, length) : 0;
+}
@@ -0,0 +1,66 @@
+#ifndef PROXY_PROTO_H
+#define PROXY_PROTO_H
+
+#include "common.h"
+
+// Protocolo entre ProxyPlayer y un motor de estrategia externo (cualquier lenguaje) sobre un
+// socket Unix SOCK_STREAM, en el orden de bytes nativo (siempre es la misma máquina).
+// Cada mensaje es un proxy_msg_header_t seguido de length bytes de payload.
+//
+//   PROXY_MSG_INIT   proxy -> motor, una vez: u32 width, height, player_count, player_id,
+//                    luego i32 cells[BOARD_CELLS(width, height)] en el layout de game_state_t.board
+//   PROXY_MSG_DELTA  proxy -> motor, pide un movimiento para el estado resultante:
+//                    u32 player_count, proxy_player_pos_t[player_count],
+//                    u32 change_count, proxy_cell_change_t[change_count]
+//                    (solo las celdas que cambiaron desde el mensaje anterior)
+//                    Con PROXY_FLAG_SPECULATIVE el estado es una predicción (nuestro último
+//                    movimiento aplicado): el motor piensa mientras el máster procesa.
+//   PROXY_MSG_MOVE   motor -> proxy: u8 direction, respondiendo al seq del pedido. El motor
+//                    puede saltear pedidos viejos y contestar solo el último; el proxy
+//                    descarta respuestas que ya no le sirven.
+//   PROXY_MSG_END    proxy -> motor: fin de la partida
+#define PROXY_PROTO_VERSION 1
+#define PROXY_ENGINE_ENV "CHOMP_PROXY_ENGINE"     // Motor a lanzar (stdin = socket, stdout = stderr)
+#define PROXY_SOCKET_ENV "CHOMP_PROXY_SOCKET"     // O conectarse a un motor que ya escucha ahí
+#define PROXY_DEADLINE_ENV "CHOMP_PROXY_DEADLINE_MS"
+#define DEFAULT_PROXY_ENGINE "./engine"
+#define DEFAULT_PROXY_DEADLINE_MS 100
+
+enum
+{
+    PROXY_MSG_INIT = 1,
+    PROXY_MSG_DELTA,
+    PROXY_MSG_MOVE,
+    PROXY_MSG_END
+};
+
+#define PROXY_FLAG_SPECULATIVE 0x1
+
+typedef struct __attribute__((packed))
+{
+    uint8_t type;
+    uint8_t flags;
+    uint16_t version;
+    uint32_t seq;
+    uint32_t length;
+} proxy_msg_header_t;
+
+typedef struct __attribute__((packed))
+{
+    int32_t x;
+    int32_t y;
+    uint8_t blocked;
+    uint8_t reserved[3];
+} proxy_player_pos_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t index; // BOARD_INDEX(width, x, y)
+    int32_t value;
+} proxy_cell_change_t;
+
+int proxy_send(int fd, uint8_t type, uint8_t flags, uint32_t seq, const void *payload, uint32_t length);
+int proxy_recv_header(int fd, proxy_msg_header_t *header);
+int proxy_recv_payload(int fd, void *payload, uint32_t length);
+
+#endif
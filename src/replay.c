@@ -0,0 +1,245 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "replay.h"
+#include "mapfile.h"
+#include "rules.h"
+
+// Motor de replay: reconstruye el tablero con initialize_board/place_players y
+// re-ejecuta process_move sobre cada registro, sin pipes ni semáforos de jugadores.
+static game_state_t *game_state = NULL;
+static game_sync_t *game_sync = NULL;
+static pid_t view_pid = INVALID_FD;
+static bool shared = false;
+
+typedef struct
+{
+    char *view_path;
+    int delay;
+    bool quiet;
+    const char *map_path;
+    const char *replay_path;
+} replay_config_t;
+
+void cleanup_resources(void)
+{
+    if (shared)
+    {
+        cleanup_shared_memory(game_state, game_sync);
+        unlink_shared_memory();
+    }
+    else
+    {
+        free(game_state);
+    }
+    game_state = NULL;
+    game_sync = NULL;
+}
+
+void signal_handler(int sig)
+{
+    (void)sig;
+    cleanup_resources();
+    exit(EXIT_FAILURE);
+}
+
+void parse_arguments(int argc, char *argv[], replay_config_t *config)
+{
+    config->view_path = NULL;
+    config->delay = 0;
+    config->quiet = false;
+    config->map_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "v:d:m:q")) != -1)
+    {
+        switch (opt)
+        {
+        case 'v':
+            config->view_path = optarg;
+            break;
+        case 'd':
+            config->delay = atoi(optarg);
+            break;
+        case 'm':
+            config->map_path = optarg;
+            break;
+        case 'q':
+            config->quiet = true;
+            break;
+        default:
+            print_usage_replay(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        print_usage_replay(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    config->replay_path = argv[optind];
+}
+
+void initialize_state(replay_config_t *config, const replay_header_t *header)
+{
+    if (config->view_path)
+    {
+        // La vista necesita las memorias compartidas de siempre
+        if (create_shared_memory(header->width, header->height, header->player_count, 0, &game_state, &game_sync) != 0)
+            error_exit("create_shared_memory");
+        shared = true;
+    }
+    else
+    {
+        game_state = calloc(1, sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(header->width, header->height));
+        if (!game_state)
+            error_exit("calloc game_state");
+        game_state->width = header->width;
+        game_state->height = header->height;
+        game_state->player_count = header->player_count;
+    }
+
+    if (config->map_path)
+    {
+        map_file_t map;
+        if (map_open(&map, config->map_path) == -1)
+            error_exit("map_open");
+        if (map.header->width != header->width || map.header->height != header->height)
+        {
+            fprintf(stderr, "Map dimensions do not match the replay\n");
+            exit(EXIT_FAILURE);
+        }
+        map_load_board(&map, game_state);
+        if (!map_restore_players(&map, game_state))
+            place_players(game_state);
+        map_close(&map);
+    }
+    else
+    {
+        board_gen_t gen = {.seed = header->seed, .rng = header->rng, .profile = header->profile, .threads = 0};
+        initialize_board(game_state, &gen);
+        place_players(game_state);
+    }
+    for (unsigned int i = 0; i < header->player_count; i++)
+        memcpy(PLAYER_NAME(game_state, i), header->names[i], PLAYER_NAME_SIZE);
+}
+
+void launch_view(replay_config_t *config)
+{
+    if (!config->view_path)
+        return;
+
+    view_pid = fork();
+    if (view_pid == -1)
+        error_exit("fork view");
+
+    if (view_pid == 0)
+    {
+        char width_str[INT_STR_BUF], height_str[INT_STR_BUF];
+        snprintf(width_str, sizeof(width_str), "%d", game_state->width);
+        snprintf(height_str, sizeof(height_str), "%d", game_state->height);
+
+        execl(config->view_path, config->view_path, width_str, height_str, NULL);
+        error_exit("execl view");
+    }
+}
+
+void notify_view(replay_config_t *config)
+{
+    if (view_pid > 0)
+    {
+        sem_post(&game_sync->view_notify);
+        sem_wait(&game_sync->view_done);
+        if (config->delay > 0)
+            usleep(config->delay * US_TO_MS);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    replay_config_t config;
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    parse_arguments(argc, argv, &config);
+
+    replay_reader_t reader;
+    if (replay_reader_open(&reader, config.replay_path) == -1)
+        error_exit("replay open");
+
+    // Con la semilla saldría otro tablero y el replay divergiría sin avisar
+    if ((reader.header.flags & REPLAY_HEADER_MAP) && !config.map_path)
+    {
+        fprintf(stderr, "%s was recorded from a map file; pass the same map with -m\n", config.replay_path);
+        replay_reader_close(&reader);
+        exit(EXIT_FAILURE);
+    }
+
+    initialize_state(&config, &reader.header);
+    launch_view(&config);
+    notify_view(&config);
+    const rule_kernels_t *rules = rules_select(game_state->width, game_state->height);
+
+    uint64_t start = monotonic_ns();
+
+    unsigned long moves = 0;
+    unsigned long mismatches = 0;
+    replay_record_t record;
+    while (replay_reader_next(&reader, &record))
+    {
+        if (record.player >= game_state->player_count)
+        {
+            mismatches++;
+            continue;
+        }
+
+        if (record.flags & REPLAY_FLAG_EOF)
+        {
+            PLAYER_BLOCKED(game_state, record.player) = true;
+            continue;
+        }
+
+        bool valid = rules->process_move(game_state, record.player, record.direction);
+        if (valid != ((record.flags & REPLAY_FLAG_VALID) != 0))
+            mismatches++;
+        moves++;
+
+        notify_view(&config);
+    }
+
+    uint64_t end = monotonic_ns();
+    game_state->game_finished = true;
+    notify_view(&config);
+
+    double elapsed = (double)(end - start) / NS_PER_SECOND;
+
+    if (view_pid > 0)
+        waitpid(view_pid, NULL, 0);
+
+    if (!config.quiet)
+    {
+        if (config.map_path)
+            printf("Replay %s: map %s, %ux%u, %u players\n", config.replay_path, config.map_path,
+                   reader.header.width, reader.header.height, reader.header.player_count);
+        else
+            printf("Replay %s: seed %u (%s, %s), %ux%u, %u players\n", config.replay_path, reader.header.seed,
+                   rng_kind_name(reader.header.rng), reward_profile_name(reader.header.profile),
+                   reader.header.width, reader.header.height, reader.header.player_count);
+        for (unsigned int i = 0; i < game_state->player_count; i++)
+        {
+            printf("Player %u (%s): Score %u, Valid %u, Invalid %u\n", i + 1, PLAYER_NAME(game_state, i),
+                   PLAYER_SCORE(game_state, i), PLAYER_VALID_MOVES(game_state, i), PLAYER_INVALID_MOVES(game_state, i));
+        }
+        int winner = find_winner(game_state);
+        if (winner >= 0)
+            printf("Winner: %s\n", PLAYER_NAME(game_state, winner));
+    }
+
+    printf("Replayed %lu moves in %.6f s (%.0f moves/s), %lu mismatches\n",
+           moves, elapsed, elapsed > 0 ? moves / elapsed : 0.0, mismatches);
+
+    replay_reader_close(&reader);
+    cleanup_resources();
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
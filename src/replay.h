@@ -0,0 +1,75 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "common.h"
+#include "board_gen.h"
+
+// Formato binario de replay:
+//   replay_header_t (semilla, generador, dimensiones y nombres; con REPLAY_HEADER_MAP el
+//   tablero salió de un archivo de mapa y la semilla no sirve para reconstruirlo)
+//   secuencia de registros varint (LEB128), uno por movimiento leído por el máster:
+//     valor = (dirección << REPLAY_DIR_SHIFT) | (jugador << REPLAY_PLAYER_SHIFT) | flags
+// La dirección es el byte crudo que mandó el jugador (puede ser inválido).
+#define REPLAY_MAGIC "CHRP"
+#define REPLAY_MAGIC_SIZE 4
+#define REPLAY_VERSION 2
+#define REPLAY_BUFFER_SIZE (64 * 1024)
+
+#define REPLAY_FLAG_VALID 0x1 // El movimiento fue aceptado por process_move
+#define REPLAY_FLAG_EOF 0x2   // El jugador cerró su pipe (se lo marcó bloqueado)
+#define REPLAY_PLAYER_SHIFT 2
+#define REPLAY_PLAYER_MASK 0xF
+#define REPLAY_DIR_SHIFT 6
+#define REPLAY_MAX_VARINT_SIZE 5
+
+#define REPLAY_HEADER_MAP 0x1 // Partida iniciada con --map: hay que reproducirla con -m
+
+typedef struct
+{
+    char magic[REPLAY_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t seed;
+    uint8_t rng;     // rng_kind_t usado por initialize_board
+    uint8_t profile; // reward_profile_t
+    uint16_t flags;  // REPLAY_HEADER_*; 0 en archivos anteriores
+    uint16_t width;
+    uint16_t height;
+    uint32_t player_count;
+    char names[MAX_PLAYERS][PLAYER_NAME_SIZE];
+} replay_header_t;
+
+typedef struct
+{
+    unsigned char player;
+    unsigned char direction;
+    unsigned char flags;
+} replay_record_t;
+
+// Escritura con buffer propio: un write() cada REPLAY_BUFFER_SIZE bytes, no por movimiento
+typedef struct
+{
+    int fd;
+    size_t used;
+    unsigned char buffer[REPLAY_BUFFER_SIZE];
+} replay_writer_t;
+
+// Lectura sobre el archivo mapeado completo
+typedef struct
+{
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+    replay_header_t header;
+} replay_reader_t;
+
+void replay_fill_header(replay_header_t *header, game_state_t *state, const board_gen_t *gen, bool from_map);
+int replay_writer_open(replay_writer_t *writer, const char *path, const replay_header_t *header);
+int replay_writer_append(replay_writer_t *writer, const replay_record_t *record);
+int replay_writer_flush(replay_writer_t *writer);
+int replay_writer_close(replay_writer_t *writer);
+
+int replay_reader_open(replay_reader_t *reader, const char *path);
+bool replay_reader_next(replay_reader_t *reader, replay_record_t *record);
+void replay_reader_close(replay_reader_t *reader);
+
+#endif
@@ -0,0 +1,157 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "replay.h"
+
+#define VARINT_PAYLOAD_MASK 0x7F
+#define VARINT_CONTINUE 0x80
+#define VARINT_PAYLOAD_BITS 7
+
+void replay_fill_header(replay_header_t *header, game_state_t *state, const board_gen_t *gen, bool from_map)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE);
+    header->version = REPLAY_VERSION;
+    header->seed = gen->seed;
+    header->rng = gen->rng;
+    header->profile = gen->profile;
+    header->flags = from_map ? REPLAY_HEADER_MAP : 0;
+    header->width = state->width;
+    header->height = state->height;
+    header->player_count = state->player_count;
+    for (unsigned int i = 0; i < state->player_count; i++)
+        memcpy(header->names[i], PLAYER_NAME(state, i), PLAYER_NAME_SIZE);
+}
+
+int replay_writer_open(replay_writer_t *writer, const char *path, const replay_header_t *header)
+{
+    writer->used = 0;
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, SHM_PERMISSIONS);
+    if (writer->fd == -1)
+        return -1;
+
+    if (write_all(writer->fd, header, sizeof(*header)) == -1)
+    {
+        close(writer->fd);
+        writer->fd = INVALID_FD;
+        return -1;
+    }
+    return 0;
+}
+
+int replay_writer_flush(replay_writer_t *writer)
+{
+    if (writer->fd == INVALID_FD || writer->used == 0)
+        return 0;
+
+    int result = write_all(writer->fd, writer->buffer, writer->used);
+    writer->used = 0;
+    return result;
+}
+
+int replay_writer_append(replay_writer_t *writer, const replay_record_t *record)
+{
+    if (writer->fd == INVALID_FD)
+        return -1;
+
+    if (writer->used + REPLAY_MAX_VARINT_SIZE > REPLAY_BUFFER_SIZE && replay_writer_flush(writer) == -1)
+        return -1;
+
+    uint32_t value = ((uint32_t)record->direction << REPLAY_DIR_SHIFT) |
+                     ((uint32_t)(record->player & REPLAY_PLAYER_MASK) << REPLAY_PLAYER_SHIFT) |
+                     (record->flags & (REPLAY_FLAG_VALID | REPLAY_FLAG_EOF));
+
+    // LEB128: 7 bits por byte, el bit alto indica que sigue otro byte
+    do
+    {
+        unsigned char byte = value & VARINT_PAYLOAD_MASK;
+        value >>= VARINT_PAYLOAD_BITS;
+        if (value)
+            byte |= VARINT_CONTINUE;
+        writer->buffer[writer->used++] = byte;
+    } while (value);
+
+    return 0;
+}
+
+int replay_writer_close(replay_writer_t *writer)
+{
+    if (writer->fd == INVALID_FD)
+        return 0;
+
+    int result = replay_writer_flush(writer);
+    if (close(writer->fd) == -1)
+        result = -1;
+    writer->fd = INVALID_FD;
+    return result;
+}
+
+int replay_reader_open(replay_reader_t *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(replay_header_t))
+    {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return -1;
+
+    reader->data = data;
+    reader->size = st.st_size;
+    memcpy(&reader->header, reader->data, sizeof(replay_header_t));
+    reader->pos = sizeof(replay_header_t);
+
+    if (memcmp(reader->header.magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE) != 0 ||
+        reader->header.version != REPLAY_VERSION ||
+        reader->header.player_count == 0 || reader->header.player_count > MAX_PLAYERS)
+    {
+        replay_reader_close(reader);
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Avisamos al kernel que el archivo se lee secuencialmente
+    madvise((void *)reader->data, reader->size, MADV_SEQUENTIAL);
+    return 0;
+}
+
+bool replay_reader_next(replay_reader_t *reader, replay_record_t *record)
+{
+    uint32_t value = 0;
+    unsigned int shift = 0;
+
+    for (;;)
+    {
+        if (reader->pos >= reader->size || shift >= REPLAY_MAX_VARINT_SIZE * VARINT_PAYLOAD_BITS)
+            return false; // Fin de archivo o registro truncado
+
+        unsigned char byte = reader->data[reader->pos++];
+        value |= (uint32_t)(byte & VARINT_PAYLOAD_MASK) << shift;
+        shift += VARINT_PAYLOAD_BITS;
+        if (!(byte & VARINT_CONTINUE))
+            break;
+    }
+
+    record->flags = value & (REPLAY_FLAG_VALID | REPLAY_FLAG_EOF);
+    record->player = (value >> REPLAY_PLAYER_SHIFT) & REPLAY_PLAYER_MASK;
+    record->direction = (unsigned char)(value >> REPLAY_DIR_SHIFT);
+    return true;
+}
+
+void replay_reader_close(replay_reader_t *reader)
+{
+    if (reader->data)
+        munmap((void *)reader->data, reader->size);
+    reader->data = NULL;
+    reader->size = 0;
+}
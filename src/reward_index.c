@@ -0,0 +1,185 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "reward_index.h"
+
+#define LOWBIT(i) ((i) & -(i))
+
+static inline int32_t *node(reward_index_t *index, int i, int j)
+{
+    return &index->tree[(size_t)(j - 1) * index->width + (i - 1)];
+}
+
+static inline int32_t load_node(const reward_index_t *index, int i, int j)
+{
+    return __atomic_load_n(&index->tree[(size_t)(j - 1) * index->width + (i - 1)], __ATOMIC_RELAXED);
+}
+
+size_t reward_index_size(int width, int height)
+{
+    return sizeof(reward_index_t) + sizeof(int32_t) * width * height;
+}
+
+reward_index_t *reward_index_alloc(int width, int height)
+{
+    reward_index_t *index = calloc(1, reward_index_size(width, height));
+    if (!index)
+        return NULL;
+    index->magic = REWARD_INDEX_MAGIC;
+    index->width = width;
+    index->height = height;
+    return index;
+}
+
+// Construcción lineal: el Fenwick 2D es separable, así que se arma el 1D de cada fila y
+// después el 1D de cada columna sobre ese resultado (cada nodo suma a su padre una vez)
+void reward_index_build(reward_index_t *index, const game_state_t *state)
+{
+    int width = index->width;
+    int height = index->height;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int value = state->board[BOARD_INDEX(width, x, y)];
+            index->tree[(size_t)y * width + x] = value >= MIN_REWARD && value <= MAX_REWARD ? value : 0;
+        }
+    }
+
+    for (int j = 1; j <= height; j++)
+    {
+        for (int i = 1; i <= width; i++)
+        {
+            int parent = i + LOWBIT(i);
+            if (parent <= width)
+                *node(index, parent, j) += *node(index, i, j);
+        }
+    }
+    for (int j = 1; j <= height; j++)
+    {
+        int parent = j + LOWBIT(j);
+        if (parent > height)
+            continue;
+        for (int i = 1; i <= width; i++)
+            *node(index, i, parent) += *node(index, i, j);
+    }
+}
+
+// Único escritor (el máster, con state_mutex tomado): load + store relajados alcanzan
+void reward_index_consume(reward_index_t *index, int x, int y, int reward)
+{
+    if (!index || reward == 0 || x < 0 || x >= index->width || y < 0 || y >= index->height)
+        return;
+
+    for (int j = y + 1; j <= index->height; j += LOWBIT(j))
+    {
+        for (int i = x + 1; i <= index->width; i += LOWBIT(i))
+        {
+            int32_t *cell = node(index, i, j);
+            __atomic_store_n(cell, __atomic_load_n(cell, __ATOMIC_RELAXED) - reward, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// Suma de [0, x) × [0, y)
+static int64_t prefix(const reward_index_t *index, int x, int y)
+{
+    int64_t sum = 0;
+    for (int j = y; j > 0; j -= LOWBIT(j))
+    {
+        for (int i = x; i > 0; i -= LOWBIT(i))
+            sum += load_node(index, i, j);
+    }
+    return sum;
+}
+
+int64_t reward_index_rect(const reward_index_t *index, int x0, int y0, int x1, int y1)
+{
+    if (x0 < 0)
+        x0 = 0;
+    if (y0 < 0)
+        y0 = 0;
+    if (x1 > index->width)
+        x1 = index->width;
+    if (y1 > index->height)
+        y1 = index->height;
+    if (x0 >= x1 || y0 >= y1)
+        return 0;
+
+    return prefix(index, x1, y1) - prefix(index, x0, y1) - prefix(index, x1, y0) + prefix(index, x0, y0);
+}
+
+// El encabezado queda listo antes de lanzar a los hijos; el árbol se arma con
+// reward_index_build una vez que el tablero existe (con state_mutex tomado)
+reward_index_t *reward_index_create(int width, int height, int shm_flags)
+{
+    size_t size = reward_index_size(width, height);
+    int fd = create_segment(GAME_INDEX_SHM, "game_index", size, shm_flags);
+    if (fd == -1)
+        return NULL;
+
+    reward_index_t *index = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    // Los jugadores solo lo leen: el memfd heredado se sella contra nuevos mapeos escribibles
+    if (index == MAP_FAILED ||
+        ((shm_flags & SHM_FLAG_MEMFD) &&
+         (seal_segment(fd, true) == -1 || export_segment_fd(SHM_INDEX_FD_ENV, fd) == -1)))
+    {
+        if (index != MAP_FAILED)
+            munmap(index, size);
+        close(fd);
+        if (!(shm_flags & SHM_FLAG_MEMFD))
+            shm_unlink_ns(GAME_INDEX_SHM);
+        return NULL;
+    }
+    if (!(shm_flags & SHM_FLAG_MEMFD))
+        close(fd); // En modo memfd lo cierra close_inherited_segments() después de lanzar a los hijos
+
+    index->width = width;
+    index->height = height;
+    __atomic_store_n(&index->magic, REWARD_INDEX_MAGIC, __ATOMIC_RELEASE);
+    return index;
+}
+
+void reward_index_destroy(reward_index_t *index, int shm_flags)
+{
+    if (!index)
+        return;
+    munmap(index, reward_index_size(index->width, index->height));
+    if (!(shm_flags & SHM_FLAG_MEMFD))
+        shm_unlink_ns(GAME_INDEX_SHM);
+}
+
+const reward_index_t *reward_index_open_readonly(int width, int height)
+{
+    int fd = open_segment(GAME_INDEX_SHM, SHM_INDEX_FD_ENV, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+
+    // El tamaño tiene que coincidir: un segmento viejo de otra partida no sirve
+    struct stat st;
+    size_t size = reward_index_size(width, height);
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size != size)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    reward_index_t *index = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index == MAP_FAILED)
+        return NULL;
+
+    if (__atomic_load_n(&index->magic, __ATOMIC_ACQUIRE) != REWARD_INDEX_MAGIC || index->width != width ||
+        index->height != height)
+    {
+        munmap(index, size);
+        return NULL;
+    }
+    return index;
+}
+
+void reward_index_close(const reward_index_t *index)
+{
+    if (index)
+        munmap((void *)index, reward_index_size(index->width, index->height));
+}
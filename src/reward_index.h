@@ -0,0 +1,39 @@
+#ifndef REWARD_INDEX_H
+#define REWARD_INDEX_H
+
+#include "common.h"
+
+// Índice de recompensa restante: un Fenwick 2D sobre el tablero (solo cuentan las celdas
+// libres). El máster lo publica de solo lectura junto al estado y lo actualiza en
+// O(log W · log H) cada vez que un movimiento consume una celda; así una estrategia puede
+// preguntar "cuánto queda en este rectángulo" en O(log W · log H) en vez de recorrerlo.
+// Hay un único escritor y las lecturas son atómicas relajadas: fuera del lock de lectores
+// un jugador puede ver el índice un movimiento adelantado, lo que para una heurística da igual.
+#define REWARD_INDEX_MAGIC 0x43484958u // "CHIX"
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t width;
+    uint16_t height;
+    int32_t tree[]; // tree[(j-1)*width + (i-1)] es el nodo (i, j) del Fenwick, 1-based
+} reward_index_t;
+
+size_t reward_index_size(int width, int height);
+// Índice en memoria privada (simulate, sim.c); se libera con free()
+reward_index_t *reward_index_alloc(int width, int height);
+// Construye el índice a partir del tablero en O(W·H)
+void reward_index_build(reward_index_t *index, const game_state_t *state);
+// La celda (x, y) dejó de valer reward (la comió un jugador)
+void reward_index_consume(reward_index_t *index, int x, int y, int reward);
+// Suma de recompensa restante en [x0, x1) × [y0, y1); recorta contra los bordes
+int64_t reward_index_rect(const reward_index_t *index, int x0, int y0, int x1, int y1);
+
+// Segmento compartido: el máster lo crea antes de lanzar a los hijos, ellos lo abren de
+// solo lectura. Sin índice (p. ej. con el máster de la cátedra) open devuelve NULL.
+reward_index_t *reward_index_create(int width, int height, int shm_flags);
+void reward_index_destroy(reward_index_t *index, int shm_flags);
+const reward_index_t *reward_index_open_readonly(int width, int height);
+void reward_index_close(const reward_index_t *index);
+
+#endif
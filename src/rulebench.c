@@ -0,0 +1,421 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "rules.h"
+#include "strategy.h"
+#include <math.h>
+
+// Microbenchmarks de las primitivas de reglas (utils.c y rules.c) y de las estrategias,
+// sobre tableros sintéticos de varios tamaños y niveles de ocupación. Cada caso corre
+// -W repeticiones de calentamiento y -r medidas de -n operaciones; se informa ns/op medio,
+// desvío, mínimo y coeficiente de variación. Las coordenadas se sortean antes de medir.
+// process_move modifica el tablero: cada operación coloca al jugador, mueve y deshace el
+// movimiento, así todas las repeticiones miden lo mismo (el deshacer entra en el tiempo,
+// igual para la versión genérica y la especializada).
+#define DEFAULT_SIZES "10,20,64,128,1000"
+#define DEFAULT_OCCUPANCY "0,50,90"
+#define DEFAULT_OPS 200000L
+#define DEFAULT_REPEATS 7
+#define DEFAULT_WARMUP 1
+#define BENCH_PLAYERS 4
+#define QUERY_COUNT 4096 // Potencia de 2: se recorre con una máscara
+#define QUERY_MASK (QUERY_COUNT - 1)
+#define MAX_LIST 16
+#define PERCENT 100
+#define MAX_SCORE 10000
+
+typedef struct
+{
+    game_state_t *state;
+    const rule_kernels_t *rules;
+    reward_index_t *index;
+    int qx[QUERY_COUNT]; // Coordenadas dentro del tablero
+    int qy[QUERY_COUNT];
+    int ox[QUERY_COUNT]; // Con un borde de una celda afuera (para is_cell_free)
+    int oy[QUERY_COUNT];
+    unsigned char dir[QUERY_COUNT];
+    long target[QUERY_COUNT]; // Celda a la que lleva dir desde (qx, qy), -1 si cae afuera
+} bench_ctx_t;
+
+typedef uint64_t (*bench_fn_t)(bench_ctx_t *ctx, long ops);
+
+typedef struct
+{
+    const char *name;
+    bench_fn_t run;
+} bench_t;
+
+typedef struct
+{
+    int sizes[MAX_LIST];
+    int size_count;
+    int occupancy[MAX_LIST];
+    int occupancy_count;
+    long ops;
+    int repeats;
+    int warmup;
+    const char *only; // Solo los casos cuyo nombre contiene esto
+} bench_config_t;
+
+static volatile uint64_t sink; // Para que el compilador no descarte los resultados
+
+void print_usage_rulebench(const char *program_name)
+{
+    printf("Usage: %s [-s sizes] [-o occupancy] [-n ops] [-r repeats] [-W warmup] [-b filter]\n", program_name);
+    printf("  -s sizes     : Comma-separated square board sizes (default: %s)\n", DEFAULT_SIZES);
+    printf("  -o occupancy : Comma-separated percentages of occupied cells (default: %s)\n", DEFAULT_OCCUPANCY);
+    printf("  -n ops       : Operations per repetition (default: %ld)\n", DEFAULT_OPS);
+    printf("  -r repeats   : Measured repetitions (default: %d)\n", DEFAULT_REPEATS);
+    printf("  -W warmup    : Unmeasured repetitions before measuring (default: %d)\n", DEFAULT_WARMUP);
+    printf("  -b filter    : Only run benchmarks whose name contains this text\n");
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static int parse_list(const char *text, int *out)
+{
+    int count = 0;
+    const char *cursor = text;
+    while (*cursor && count < MAX_LIST)
+    {
+        char *end;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor || value < 0 || (*end != ',' && *end != '\0'))
+            return -1;
+        out[count++] = (int)value;
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return *cursor == '\0' && count > 0 ? count : -1;
+}
+
+static void place_player(game_state_t *state, unsigned int player_id, int x, int y)
+{
+    PLAYER_X(state, player_id) = x;
+    PLAYER_Y(state, player_id) = y;
+    PLAYER_BLOCKED(state, player_id) = false;
+}
+
+// Tablero con occupancy% de celdas de algún jugador y el resto recompensas
+static void build_board(bench_ctx_t *ctx, int size, int occupancy)
+{
+    game_state_t *state = ctx->state;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)size << 32 | (uint64_t)occupancy);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            uint64_t r = next_random(&rng);
+            state->board[BOARD_INDEX(size, x, y)] = (int)(r % PERCENT) < occupancy
+                                                        ? -(int)((r >> 16) % BENCH_PLAYERS)
+                                                        : MIN_REWARD + (int)((r >> 32) % MAX_REWARD);
+        }
+    }
+    for (unsigned int i = 0; i < BENCH_PLAYERS; i++)
+    {
+        place_player(state, i, (int)(next_random(&rng) % size), (int)(next_random(&rng) % size));
+        PLAYER_SCORE(state, i) = (unsigned int)(next_random(&rng) % MAX_SCORE);
+        PLAYER_VALID_MOVES(state, i) = (unsigned int)(next_random(&rng) % MAX_SCORE);
+        PLAYER_INVALID_MOVES(state, i) = (unsigned int)(next_random(&rng) % MAX_SCORE);
+    }
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        ctx->qx[i] = (int)(next_random(&rng) % size);
+        ctx->qy[i] = (int)(next_random(&rng) % size);
+        ctx->ox[i] = (int)(next_random(&rng) % (size + 2)) - 1;
+        ctx->oy[i] = (int)(next_random(&rng) % (size + 2)) - 1;
+        ctx->dir[i] = (unsigned char)(next_random(&rng) % DIRECTIONS_COUNT);
+
+        int dx, dy;
+        get_direction_offset(ctx->dir[i], &dx, &dy);
+        int nx = ctx->qx[i] + dx, ny = ctx->qy[i] + dy;
+        ctx->target[i] = nx >= 0 && nx < size && ny >= 0 && ny < size ? (long)BOARD_INDEX(size, nx, ny) : -1;
+    }
+    reward_index_build(ctx->index, state);
+}
+
+static uint64_t bench_get_board_cell(bench_ctx_t *ctx, long ops)
+{
+    uint64_t sum = 0;
+    for (long i = 0; i < ops; i++)
+        sum += get_board_cell(ctx->state, ctx->qx[i & QUERY_MASK], ctx->qy[i & QUERY_MASK]);
+    return sum;
+}
+
+static uint64_t bench_is_cell_free(bench_ctx_t *ctx, long ops)
+{
+    uint64_t sum = 0;
+    for (long i = 0; i < ops; i++)
+        sum += is_cell_free(ctx->state, ctx->ox[i & QUERY_MASK], ctx->oy[i & QUERY_MASK]);
+    return sum;
+}
+
+static uint64_t bench_get_direction_offset(bench_ctx_t *ctx, long ops)
+{
+    uint64_t sum = 0;
+    for (long i = 0; i < ops; i++)
+    {
+        int dx, dy;
+        get_direction_offset(ctx->dir[i & QUERY_MASK], &dx, &dy);
+        sum += (unsigned int)(dx * 3 + dy);
+    }
+    return sum;
+}
+
+static uint64_t run_has_valid_moves(bench_ctx_t *ctx, long ops, bool (*has_valid_moves)(game_state_t *, unsigned int))
+{
+    uint64_t sum = 0;
+    for (long i = 0; i < ops; i++)
+    {
+        PLAYER_X(ctx->state, 0) = ctx->qx[i & QUERY_MASK];
+        PLAYER_Y(ctx->state, 0) = ctx->qy[i & QUERY_MASK];
+        sum += has_valid_moves(ctx->state, 0);
+    }
+    return sum;
+}
+
+static uint64_t bench_has_valid_moves(bench_ctx_t *ctx, long ops)
+{
+    return run_has_valid_moves(ctx, ops, player_has_valid_moves);
+}
+
+static uint64_t bench_rules_has_valid_moves(bench_ctx_t *ctx, long ops)
+{
+    return run_has_valid_moves(ctx, ops, ctx->rules->has_valid_moves);
+}
+
+// Coloca al jugador 0, mueve y deshace (celda destino, posición, contadores y bloqueo)
+static uint64_t run_process_move(bench_ctx_t *ctx, long ops, bool (*move)(game_state_t *, int, unsigned char))
+{
+    game_state_t *state = ctx->state;
+    unsigned int score = PLAYER_SCORE(state, 0);
+    unsigned int valid_moves = PLAYER_VALID_MOVES(state, 0);
+    unsigned int invalid_moves = PLAYER_INVALID_MOVES(state, 0);
+    uint64_t sum = 0;
+
+    for (long i = 0; i < ops; i++)
+    {
+        place_player(state, 0, ctx->qx[i & QUERY_MASK], ctx->qy[i & QUERY_MASK]);
+        long cell = ctx->target[i & QUERY_MASK];
+        int *target = cell >= 0 ? &state->board[cell] : NULL;
+        int saved = target ? *target : 0;
+
+        sum += move(state, 0, ctx->dir[i & QUERY_MASK]);
+
+        if (target)
+            *target = saved;
+        PLAYER_SCORE(state, 0) = score;
+        PLAYER_VALID_MOVES(state, 0) = valid_moves;
+        PLAYER_INVALID_MOVES(state, 0) = invalid_moves;
+    }
+    PLAYER_BLOCKED(state, 0) = false;
+    return sum;
+}
+
+static uint64_t bench_process_move(bench_ctx_t *ctx, long ops)
+{
+    return run_process_move(ctx, ops, process_move);
+}
+
+static uint64_t bench_rules_process_move(bench_ctx_t *ctx, long ops)
+{
+    return run_process_move(ctx, ops, ctx->rules->process_move);
+}
+
+static uint64_t bench_find_winner(bench_ctx_t *ctx, long ops)
+{
+    uint64_t sum = 0;
+    for (long i = 0; i < ops; i++)
+    {
+        PLAYER_SCORE(ctx->state, i % BENCH_PLAYERS) = (unsigned int)ctx->qx[i & QUERY_MASK];
+        sum += (unsigned int)find_winner(ctx->state);
+    }
+    return sum;
+}
+
+static uint64_t run_strategy(bench_ctx_t *ctx, long ops, const chomp_strategy_t *strategy, bool indexed)
+{
+    game_state_t *state = ctx->state;
+    board_view_t board = {state->board, state->width, state->height, state->player_count,
+                          indexed ? ctx->index : NULL};
+    void *strategy_state = strategy->state_size ? calloc(1, strategy->state_size) : NULL;
+    if (strategy->state_size && !strategy_state)
+        error_exit("calloc strategy_state");
+    uint64_t sum = 0;
+    for (long i = 0; i < ops; i++)
+    {
+        player_t me = {.x = ctx->qx[i & QUERY_MASK], .y = ctx->qy[i & QUERY_MASK]};
+        sum += strategy->choose(&board, &me, strategy_state);
+    }
+    free(strategy_state);
+    return sum;
+}
+
+static uint64_t bench_greedy(bench_ctx_t *ctx, long ops)
+{
+    return run_strategy(ctx, ops, &greedy_strategy, false);
+}
+
+static uint64_t bench_perimeter(bench_ctx_t *ctx, long ops)
+{
+    return run_strategy(ctx, ops, &perimeter_strategy, false);
+}
+
+static uint64_t bench_region_scan(bench_ctx_t *ctx, long ops)
+{
+    return run_strategy(ctx, ops, &region_strategy, false);
+}
+
+static uint64_t bench_region_index(bench_ctx_t *ctx, long ops)
+{
+    return run_strategy(ctx, ops, &region_strategy, true);
+}
+
+static const bench_t benches[] = {
+    {"get_board_cell", bench_get_board_cell},
+    {"is_cell_free", bench_is_cell_free},
+    {"get_direction_offset", bench_get_direction_offset},
+    {"player_has_valid_moves", bench_has_valid_moves},
+    {"rules.has_valid_moves", bench_rules_has_valid_moves},
+    {"process_move", bench_process_move},
+    {"rules.process_move", bench_rules_process_move},
+    {"find_winner", bench_find_winner},
+    {"greedy.choose", bench_greedy},
+    {"perimeter.choose", bench_perimeter},
+    {"region.choose", bench_region_scan},
+    {"region.choose+index", bench_region_index},
+};
+
+// Las estrategias caras recorren regiones enteras: se les da menos operaciones por
+// repetición para que un tablero grande no tarde minutos
+static long ops_for(const bench_t *bench, const bench_config_t *config, int size)
+{
+    if (bench->run == bench_region_scan || bench->run == bench_perimeter)
+    {
+        long scaled = config->ops / (size > 0 ? size : 1);
+        return scaled > 0 ? scaled : 1;
+    }
+    return config->ops;
+}
+
+static void run_bench(const bench_t *bench, bench_ctx_t *ctx, const bench_config_t *config, int size, int occupancy)
+{
+    long ops = ops_for(bench, config, size);
+    int repeats = config->repeats;
+    double *ns_per_op = malloc(sizeof(double) * repeats);
+    if (!ns_per_op)
+        error_exit("malloc ns_per_op");
+
+    for (int w = 0; w < config->warmup; w++)
+        sink += bench->run(ctx, ops);
+
+    double sum = 0, min = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        uint64_t start = monotonic_ns();
+        sink += bench->run(ctx, ops);
+        ns_per_op[r] = (double)(monotonic_ns() - start) / ops;
+        sum += ns_per_op[r];
+        if (r == 0 || ns_per_op[r] < min)
+            min = ns_per_op[r];
+    }
+    double mean = sum / repeats;
+    double variance = 0;
+    for (int r = 0; r < repeats; r++)
+        variance += (ns_per_op[r] - mean) * (ns_per_op[r] - mean);
+    double stddev = sqrt(variance / (repeats - 1));
+    free(ns_per_op);
+
+    const char *kernel = strncmp(bench->name, "rules.", 6) == 0 ? ctx->rules->name : "";
+    printf("%6d %4d%% %-24s %-8s %10.2f %8.2f %10.2f %6.1f%%\n", size, occupancy, bench->name, kernel, mean, stddev,
+           min, mean > 0 ? PERCENT * stddev / mean : 0.0);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_config_t config = {.ops = DEFAULT_OPS, .repeats = DEFAULT_REPEATS, .warmup = DEFAULT_WARMUP};
+    config.size_count = parse_list(DEFAULT_SIZES, config.sizes);
+    config.occupancy_count = parse_list(DEFAULT_OCCUPANCY, config.occupancy);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:o:n:r:W:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            config.size_count = parse_list(optarg, config.sizes);
+            break;
+        case 'o':
+            config.occupancy_count = parse_list(optarg, config.occupancy);
+            break;
+        case 'n':
+            config.ops = atol(optarg);
+            break;
+        case 'r':
+            config.repeats = atoi(optarg);
+            break;
+        case 'W':
+            config.warmup = atoi(optarg);
+            break;
+        case 'b':
+            config.only = optarg;
+            break;
+        default:
+            print_usage_rulebench(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    bool valid = config.size_count > 0 && config.occupancy_count > 0 && config.ops > 0 && config.repeats > 1 &&
+                 config.warmup >= 0;
+    for (int i = 0; valid && i < config.size_count; i++)
+        valid = config.sizes[i] >= MIN_BOARD_SIZE && config.sizes[i] <= UINT16_MAX;
+    for (int i = 0; valid && i < config.occupancy_count; i++)
+        valid = config.occupancy[i] <= PERCENT;
+    if (!valid)
+    {
+        print_usage_rulebench(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench_ctx_t *ctx = calloc(1, sizeof(bench_ctx_t));
+    if (!ctx)
+        error_exit("calloc bench_ctx");
+
+    printf("%ld ops x %d repeats (+%d warm-up), %d players, board %s\n", config.ops, config.repeats, config.warmup,
+           BENCH_PLAYERS, BOARD_ROWMAJOR ? "rowmajor" : "tiled");
+    printf("%6s %5s %-24s %-8s %10s %8s %10s %7s\n", "size", "occ", "bench", "kernel", "ns/op", "stddev", "min",
+           "cv");
+
+    for (int s = 0; s < config.size_count; s++)
+    {
+        int size = config.sizes[s];
+        ctx->state = calloc(1, sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(size, size));
+        ctx->index = reward_index_alloc(size, size);
+        if (!ctx->state || !ctx->index)
+            error_exit("malloc board");
+        ctx->state->width = size;
+        ctx->state->height = size;
+        ctx->state->player_count = BENCH_PLAYERS;
+        ctx->rules = rules_select(size, size);
+
+        for (int o = 0; o < config.occupancy_count; o++)
+        {
+            build_board(ctx, size, config.occupancy[o]);
+            for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++)
+            {
+                if (!config.only || strstr(benches[b].name, config.only))
+                    run_bench(&benches[b], ctx, &config, size, config.occupancy[o]);
+            }
+        }
+        free(ctx->state);
+        free(ctx->index);
+    }
+
+    free(ctx);
+    return EXIT_SUCCESS;
+}
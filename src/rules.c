@@ -0,0 +1,126 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "rules.h"
+#include "probes.h"
+
+// Mismo orden que get_direction_offset (DIR_UP .. DIR_UP_LEFT)
+static const int direction_dx[DIRECTIONS_COUNT] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int direction_dy[DIRECTIONS_COUNT] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+static inline bool is_reward(int value)
+{
+    return value >= MIN_REWARD && value <= MAX_REWARD;
+}
+
+// Con width y height constantes en el llamador, la comparación sin signo cubre los cuatro
+// bordes y BOARD_INDEX se pliega a constantes
+static inline bool free_cell_at(const int *board, int width, int height, int x, int y)
+{
+    return (unsigned)x < (unsigned)width && (unsigned)y < (unsigned)height &&
+           is_reward(board[BOARD_INDEX(width, x, y)]);
+}
+
+// Los 8 vecinos desenrollados, en el orden de las direcciones
+#define ANY_NEIGHBOUR_FREE(CELL)                                                                      \
+    (CELL(0, -1) || CELL(1, -1) || CELL(1, 0) || CELL(1, 1) || CELL(0, 1) || CELL(-1, 1) || CELL(-1, 0) || \
+     CELL(-1, -1))
+// Celda interior con orden de filas: cada vecino es un desplazamiento constante desde center
+#define INTERIOR_CELL(dx, dy) is_reward(center[(dy) * width + (dx)])
+#define BORDER_CELL(dx, dy) free_cell_at(board, width, height, x + (dx), y + (dy))
+
+// Instancia player_has_valid_moves, process_move y check_game_end para un tablero W x H.
+// Misma semántica (y mismos probes) que las versiones de utils.c.
+#define DEFINE_RULE_KERNELS(W, H)                                                                   \
+    static bool has_valid_moves_##W##x##H(game_state_t *state, unsigned int player_id)             \
+    {                                                                                               \
+        const int width = (W), height = (H);                                                        \
+        if (player_id >= state->player_count)                                                       \
+            return false;                                                                           \
+        const int *board = state->board;                                                            \
+        int x = PLAYER_X(state, player_id);                                                         \
+        int y = PLAYER_Y(state, player_id);                                                         \
+        if (BOARD_ROWMAJOR && x > 0 && x < width - 1 && y > 0 && y < height - 1)                    \
+        {                                                                                           \
+            const int *center = &board[y * width + x];                                              \
+            return ANY_NEIGHBOUR_FREE(INTERIOR_CELL);                                               \
+        }                                                                                           \
+        return ANY_NEIGHBOUR_FREE(BORDER_CELL);                                                     \
+    }                                                                                               \
+                                                                                                    \
+    static bool process_move_##W##x##H(game_state_t *state, int player_id, unsigned char direction) \
+    {                                                                                               \
+        if (player_id < 0 || (unsigned int)player_id >= state->player_count ||                      \
+            PLAYER_BLOCKED(state, player_id))                                                       \
+            return false;                                                                           \
+                                                                                                    \
+        int dx = direction < DIRECTIONS_COUNT ? direction_dx[direction] : 0;                        \
+        int dy = direction < DIRECTIONS_COUNT ? direction_dy[direction] : 0;                        \
+        int new_x = PLAYER_X(state, player_id) + dx;                                                \
+        int new_y = PLAYER_Y(state, player_id) + dy;                                                \
+                                                                                                    \
+        bool valid = free_cell_at(state->board, (W), (H), new_x, new_y);                            \
+        if (valid)                                                                                  \
+        {                                                                                           \
+            int *cell = &state->board[BOARD_INDEX((W), new_x, new_y)];                              \
+            int reward = *cell;                                                                     \
+            PLAYER_SCORE(state, player_id) += reward;                                               \
+            PLAYER_VALID_MOVES(state, player_id)++;                                                 \
+            PLAYER_X(state, player_id) = new_x;                                                     \
+            PLAYER_Y(state, player_id) = new_y;                                                     \
+            *cell = -player_id;                                                                     \
+            CHOMP_PROBE4(move_applied, player_id, direction, 1, reward);                            \
+        }                                                                                           \
+        else                                                                                        \
+        {                                                                                           \
+            PLAYER_INVALID_MOVES(state, player_id)++;                                               \
+            CHOMP_PROBE4(move_applied, player_id, direction, 0, 0);                                 \
+        }                                                                                           \
+                                                                                                    \
+        if (!has_valid_moves_##W##x##H(state, player_id))                                           \
+        {                                                                                           \
+            PLAYER_BLOCKED(state, player_id) = true;                                                \
+            CHOMP_PROBE1(player_blocked, player_id);                                                \
+        }                                                                                           \
+        return valid;                                                                               \
+    }                                                                                               \
+                                                                                                    \
+    static bool game_over_##W##x##H(game_state_t *state)                                            \
+    {                                                                                               \
+        for (unsigned int i = 0; i < state->player_count; i++)                                      \
+        {                                                                                           \
+            if (!PLAYER_BLOCKED(state, i) && has_valid_moves_##W##x##H(state, i))                   \
+                return false;                                                                       \
+        }                                                                                           \
+        return true;                                                                                \
+    }
+
+#define RULE_KERNELS(W, H) {#W "x" #H, (W), (H), has_valid_moves_##W##x##H, process_move_##W##x##H, game_over_##W##x##H}
+
+// Tamaños especializados: el default del máster, el mínimo y los de las pruebas de carga
+DEFINE_RULE_KERNELS(10, 10)
+DEFINE_RULE_KERNELS(20, 20)
+DEFINE_RULE_KERNELS(64, 64)
+DEFINE_RULE_KERNELS(128, 128)
+
+static const rule_kernels_t specialized_rules[] = {
+    RULE_KERNELS(10, 10),
+    RULE_KERNELS(20, 20),
+    RULE_KERNELS(64, 64),
+    RULE_KERNELS(128, 128),
+};
+
+static const rule_kernels_t generic_rules = {"generic", 0, 0, player_has_valid_moves, process_move, check_game_end};
+
+const rule_kernels_t *rules_select(int width, int height)
+{
+    const char *forced = getenv(RULES_ENV);
+    if (forced && strcmp(forced, generic_rules.name) == 0)
+        return &generic_rules;
+
+    for (size_t i = 0; i < sizeof(specialized_rules) / sizeof(specialized_rules[0]); i++)
+    {
+        if (specialized_rules[i].width == width && specialized_rules[i].height == height)
+            return &specialized_rules[i];
+    }
+    return &generic_rules;
+}
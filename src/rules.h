@@ -0,0 +1,27 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "common.h"
+
+// Reglas del juego especializadas por tamaño de tablero. Para los tamaños más usados hay
+// una copia de player_has_valid_moves, process_move y check_game_end instanciada con
+// ancho y alto constantes (rules.c): índices con stride fijo, los 8 vecinos desenrollados
+// y, en celdas interiores, desplazamientos precalculados sin chequeo de bordes. Para
+// cualquier otro tamaño se usan las funciones genéricas de utils.c.
+// CHOMP_RULES=generic fuerza el camino genérico (para comparar).
+#define RULES_ENV "CHOMP_RULES"
+
+typedef struct
+{
+    const char *name; // "20x20", ... o "generic"
+    int width;        // 0 en el genérico
+    int height;
+    bool (*has_valid_moves)(game_state_t *state, unsigned int player_id);
+    bool (*process_move)(game_state_t *state, int player_id, unsigned char direction);
+    bool (*game_over)(game_state_t *state); // Mismo criterio que check_game_end
+} rule_kernels_t;
+
+// Se elige una vez, al conocer las dimensiones
+const rule_kernels_t *rules_select(int width, int height);
+
+#endif
@@ -0,0 +1,179 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "board_scan.h"
+
+// Ancho de banda de los recorridos de tablero completo (board_scan.h) con cada ISA que
+// soporte la CPU: "count" es celdas libres + recompensa (owners = 0) y "summary" agrega el
+// histograma de los MAX_PLAYERS jugadores. "convert" compara board_to_rowmajor contra la
+// copia celda por celda con BOARD_INDEX (depende de con qué BOARD se compiló).
+// Los resultados tienen que coincidir con los de la versión escalar.
+#define DEFAULT_BENCH_SIZE 4000
+#define DEFAULT_REPEATS 5
+#define OWNED_PER_MILLE 400 // Celdas ocupadas por algún jugador
+#define PER_MILLE 1000
+#define BYTES_PER_GB 1e9
+
+static const char *const isa_names[] = {"scalar", "sse2", "avx2"};
+#define ISA_COUNT (sizeof(isa_names) / sizeof(isa_names[0]))
+
+void print_usage_scanbench(const char *program_name)
+{
+    printf("Usage: %s [-w width] [-h height] [-r repeats]\n", program_name);
+    printf("  -w, -h : Board size (default: %dx%d)\n", DEFAULT_BENCH_SIZE, DEFAULT_BENCH_SIZE);
+    printf("  -r     : Repetitions, the best one is reported (default: %d)\n", DEFAULT_REPEATS);
+}
+
+static uint64_t next_random(uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static void fill_board(game_state_t *state)
+{
+    uint64_t rng = 0x2545F4914F6CDD1DULL;
+    for (int y = 0; y < state->height; y++)
+    {
+        for (int x = 0; x < state->width; x++)
+        {
+            uint64_t r = next_random(&rng);
+            state->board[BOARD_INDEX(state->width, x, y)] =
+                (int)(r % PER_MILLE) < OWNED_PER_MILLE ? -(int)((r >> 16) % MAX_PLAYERS)
+                                                       : MIN_REWARD + (int)((r >> 32) % MAX_REWARD);
+        }
+    }
+}
+
+static double gb_per_s(size_t bytes, uint64_t ns)
+{
+    return ns ? (double)bytes / BYTES_PER_GB / ((double)ns / NS_PER_SECOND) : 0.0;
+}
+
+// Mejor tiempo de repeats corridas de board_summarize con la ISA activa
+static uint64_t time_summary(const game_state_t *state, int repeats, bool histogram, board_summary_t *out)
+{
+    uint64_t best = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        uint64_t start = monotonic_ns();
+        if (histogram)
+            board_summarize(state, out);
+        else
+        {
+            memset(out, 0, sizeof(*out));
+            board_scan(state->board, BOARD_CELLS(state->width, state->height), 0, out);
+        }
+        uint64_t elapsed = monotonic_ns() - start;
+        if (best == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+static void convert_per_cell(const game_state_t *state, int *out)
+{
+    for (int y = 0; y < state->height; y++)
+    {
+        for (int x = 0; x < state->width; x++)
+            out[y * state->width + x] = state->board[BOARD_INDEX(state->width, x, y)];
+    }
+}
+
+static uint64_t time_convert(const game_state_t *state, int *out, int repeats, bool per_cell)
+{
+    uint64_t best = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        uint64_t start = monotonic_ns();
+        if (per_cell)
+            convert_per_cell(state, out);
+        else
+            board_to_rowmajor(state, out);
+        uint64_t elapsed = monotonic_ns() - start;
+        if (best == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    int width = DEFAULT_BENCH_SIZE, height = DEFAULT_BENCH_SIZE, repeats = DEFAULT_REPEATS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 'r':
+            repeats = atoi(optarg);
+            break;
+        default:
+            print_usage_scanbench(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (width < MIN_BOARD_SIZE || height < MIN_BOARD_SIZE || repeats < 1)
+    {
+        print_usage_scanbench(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t cells = (size_t)width * height;
+    game_state_t *state = calloc(1, sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(width, height));
+    int *rowmajor = malloc(sizeof(int) * cells);
+    if (!state || !rowmajor)
+        error_exit("malloc board");
+    state->width = width;
+    state->height = height;
+    state->player_count = MAX_PLAYERS;
+    fill_board(state);
+
+    size_t bytes = sizeof(int) * cells;
+    printf("board %dx%d (%.1f MB, %s), best of %d, default isa %s\n", width, height, (double)bytes / (1 << 20),
+           BOARD_ROWMAJOR ? "rowmajor" : "tiled", repeats, board_scan_isa());
+    printf("%-8s %-8s %10s %8s %s\n", "bench", "isa", "ms", "GB/s", "result");
+
+    int status = EXIT_SUCCESS;
+    board_summary_t reference[2];
+    for (size_t i = 0; i < ISA_COUNT; i++)
+    {
+        if (board_scan_use(isa_names[i]) == -1)
+        {
+            printf("%-8s %-8s %10s\n", "-", isa_names[i], "unsupported");
+            continue;
+        }
+        for (int histogram = 0; histogram < 2; histogram++)
+        {
+            board_summary_t summary;
+            uint64_t ns = time_summary(state, repeats, histogram, &summary);
+            if (i == 0)
+                reference[histogram] = summary;
+            bool match = memcmp(&summary, &reference[histogram], sizeof(summary)) == 0;
+            printf("%-8s %-8s %10.3f %8.2f free=%lu reward=%lu owned0=%lu%s\n", histogram ? "summary" : "count",
+                   isa_names[i], (double)ns / NS_PER_MS, gb_per_s(bytes, ns), (unsigned long)summary.free_cells,
+                   (unsigned long)summary.reward, (unsigned long)summary.owned[0], match ? "" : " MISMATCH");
+            if (!match)
+                status = EXIT_FAILURE;
+        }
+    }
+
+    // Copia: se leen y se escriben bytes, así que cuentan dos veces
+    uint64_t per_cell_ns = time_convert(state, rowmajor, repeats, true);
+    printf("%-8s %-8s %10.3f %8.2f\n", "convert", "per-cell", (double)per_cell_ns / NS_PER_MS,
+           gb_per_s(2 * bytes, per_cell_ns));
+    uint64_t rows_ns = time_convert(state, rowmajor, repeats, false);
+    printf("%-8s %-8s %10.3f %8.2f\n", "convert", "rows", (double)rows_ns / NS_PER_MS, gb_per_s(2 * bytes, rows_ns));
+
+    free(state);
+    free(rowmajor);
+    return status;
+}
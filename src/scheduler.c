@@ -0,0 +1,132 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "scheduler.h"
+
+static const char *const policy_names[] = {"rr", "fifo", "wfq"};
+
+int scheduler_parse(const char *spec, scheduler_policy_t *policy, uint32_t weights[MAX_PLAYERS])
+{
+    for (int i = 0; i < MAX_PLAYERS; i++)
+        weights[i] = 1;
+
+    size_t name_len = strcspn(spec, ":");
+    int found = -1;
+    for (size_t i = 0; i < sizeof(policy_names) / sizeof(policy_names[0]); i++)
+    {
+        if (strlen(policy_names[i]) == name_len && strncmp(spec, policy_names[i], name_len) == 0)
+            found = (int)i;
+    }
+    if (found == -1)
+        return -1;
+    *policy = (scheduler_policy_t)found;
+
+    if (spec[name_len] == '\0')
+        return 0;
+    if (*policy != SCHEDULER_WFQ) // Solo wfq lleva pesos
+        return -1;
+
+    const char *cursor = spec + name_len + 1;
+    for (int i = 0; i < MAX_PLAYERS && *cursor; i++)
+    {
+        char *end;
+        long weight = strtol(cursor, &end, 10);
+        if (end == cursor || weight < 1 || weight > SCHED_MAX_WEIGHT || (*end != ',' && *end != '\0'))
+            return -1;
+        weights[i] = (uint32_t)weight;
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return *cursor == '\0' ? 0 : -1;
+}
+
+const char *scheduler_policy_name(scheduler_policy_t policy)
+{
+    return (unsigned int)policy < sizeof(policy_names) / sizeof(policy_names[0]) ? policy_names[policy] : "?";
+}
+
+void scheduler_init(scheduler_t *sched, scheduler_policy_t policy, unsigned int player_count,
+                    const uint32_t *weights)
+{
+    memset(sched, 0, sizeof(*sched));
+    sched->policy = policy;
+    sched->player_count = player_count;
+    sched->active_mask = player_count >= 32 ? UINT32_MAX : (1u << player_count) - 1;
+    for (unsigned int i = 0; i < player_count; i++)
+        sched->weight[i] = weights && weights[i] ? weights[i] : 1;
+}
+
+void scheduler_mark_ready(scheduler_t *sched, unsigned int player_id, uint64_t now)
+{
+    if (!scheduler_is_active(sched, player_id) || scheduler_is_ready(sched, player_id))
+        return;
+
+    sched->ready_mask |= 1u << player_id;
+    sched->ready_since[player_id] = now;
+    sched->bypass[player_id] = 0;
+    // Un jugador que estuvo sin mover no acumula crédito: arranca desde el tiempo virtual actual
+    if (sched->virtual_time[player_id] < sched->virtual_now)
+        sched->virtual_time[player_id] = sched->virtual_now;
+}
+
+// Recorre los listos en orden round-robin desde cursor; el primero con la menor clave gana,
+// así los empates se resuelven como en rr
+static int pick(const scheduler_t *sched)
+{
+    int best = -1;
+    uint64_t best_key = 0;
+    for (unsigned int k = 0; k < sched->player_count; k++)
+    {
+        unsigned int p = (sched->cursor + k) % sched->player_count;
+        if (!scheduler_is_ready(sched, p))
+            continue;
+
+        uint64_t key = 0;
+        if (sched->policy == SCHEDULER_FIFO)
+            key = sched->ready_since[p];
+        else if (sched->policy == SCHEDULER_WFQ)
+            key = sched->virtual_time[p];
+        else
+            return (int)p; // rr: el primero listo
+
+        if (best == -1 || key < best_key)
+        {
+            best = (int)p;
+            best_key = key;
+        }
+    }
+    return best;
+}
+
+int scheduler_next(scheduler_t *sched, uint64_t now)
+{
+    int player_id = pick(sched);
+    if (player_id == -1)
+        return -1;
+
+    sched->ready_mask &= ~(1u << player_id);
+    scheduler_player_stats_t *stats = &sched->stats[player_id];
+    uint64_t wait = now - sched->ready_since[player_id];
+    stats->served++;
+    stats->wait_sum_ns += wait;
+    if (wait > stats->wait_max_ns)
+        stats->wait_max_ns = wait;
+
+    // Los que siguen esperando fueron salteados una vez más
+    for (unsigned int p = 0; p < sched->player_count; p++)
+    {
+        if (!scheduler_is_ready(sched, p))
+            continue;
+        if (++sched->bypass[p] > sched->stats[p].max_bypass)
+            sched->stats[p].max_bypass = sched->bypass[p];
+    }
+
+    sched->cursor = (player_id + 1) % sched->player_count;
+    sched->virtual_now = sched->virtual_time[player_id];
+    sched->virtual_time[player_id] += SCHED_VIRTUAL_UNIT / sched->weight[player_id];
+    return player_id;
+}
+
+void scheduler_remove(scheduler_t *sched, unsigned int player_id)
+{
+    sched->active_mask &= ~(1u << player_id);
+    sched->ready_mask &= ~(1u << player_id);
+}
@@ -0,0 +1,72 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "common.h"
+
+// Cola de listos del game loop: un jugador entra cuando select() ve un movimiento en su
+// pipe y sale cuando el máster lo atiende. Los bloqueados se sacan una vez
+// (scheduler_remove) y no se vuelven a mirar. La política decide a quién se atiende:
+//   rr   round-robin estricto a partir del último atendido (el comportamiento de siempre)
+//   fifo orden de llegada (cuándo se vio el movimiento); empates en round-robin
+//   wfq  reparto justo ponderado: se atiende al de menor tiempo virtual, que avanza
+//        SCHED_VIRTUAL_UNIT / peso por movimiento
+// Además mide, por jugador, cuánto esperó cada movimiento en la cola y cuántos movimientos
+// ajenos se atendieron seguidos mientras esperaba (inanición).
+#define SCHED_VIRTUAL_UNIT 1000000ULL
+#define SCHED_MAX_WEIGHT 1000
+
+typedef enum
+{
+    SCHEDULER_RR = 0,
+    SCHEDULER_FIFO,
+    SCHEDULER_WFQ
+} scheduler_policy_t;
+
+typedef struct
+{
+    uint64_t served;
+    uint64_t wait_sum_ns; // Desde que select vio el movimiento hasta atenderlo
+    uint64_t wait_max_ns;
+    uint64_t max_bypass;  // Máximo de movimientos ajenos atendidos mientras este esperaba
+} scheduler_player_stats_t;
+
+typedef struct
+{
+    scheduler_policy_t policy;
+    unsigned int player_count;
+    uint32_t active_mask; // Jugadores no bloqueados
+    uint32_t ready_mask;  // Con un movimiento esperando
+    unsigned int cursor;  // Próximo en el orden round-robin
+    uint64_t ready_since[MAX_PLAYERS];
+    uint32_t weight[MAX_PLAYERS];
+    uint64_t virtual_time[MAX_PLAYERS];
+    uint64_t virtual_now; // Tiempo virtual del último atendido: piso para los que vuelven a estar listos
+    uint64_t bypass[MAX_PLAYERS]; // Movimientos ajenos desde que este quedó listo
+    scheduler_player_stats_t stats[MAX_PLAYERS];
+} scheduler_t;
+
+// "rr", "fifo" o "wfq[:w0,w1,...]" (pesos faltantes = 1); -1 si no se entiende
+int scheduler_parse(const char *spec, scheduler_policy_t *policy, uint32_t weights[MAX_PLAYERS]);
+const char *scheduler_policy_name(scheduler_policy_t policy);
+
+// weights puede ser NULL (todos 1)
+void scheduler_init(scheduler_t *sched, scheduler_policy_t policy, unsigned int player_count,
+                    const uint32_t *weights);
+// Idempotente: si ya estaba listo conserva su hora de llegada
+void scheduler_mark_ready(scheduler_t *sched, unsigned int player_id, uint64_t now);
+// Saca y devuelve al próximo a atender (-1 si la cola está vacía) y registra su espera
+int scheduler_next(scheduler_t *sched, uint64_t now);
+// El jugador quedó bloqueado (o cerró su pipe): sale de la cola para siempre
+void scheduler_remove(scheduler_t *sched, unsigned int player_id);
+
+static inline bool scheduler_is_active(const scheduler_t *sched, unsigned int player_id)
+{
+    return sched->active_mask & (1u << player_id);
+}
+
+static inline bool scheduler_is_ready(const scheduler_t *sched, unsigned int player_id)
+{
+    return sched->ready_mask & (1u << player_id);
+}
+
+#endif
@@ -0,0 +1,251 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "common.h"
+#include "board_gen.h"
+#include <sys/resource.h>
+
+// Costo de mapear el segmento del estado con cada combinación de --hugepages, --prefault y
+// --mlock (SHM_FLAG_*), medido como lo paga una partida:
+//   map      el máster crea y mapea el segmento (acá se cargan las páginas con --prefault)
+//   fill     el máster llena el tablero (initialize_board)
+//   connect  un jugador (proceso hijo) mapea el segmento, con los flags heredados por entorno
+//   first    su primera copia completa del tablero (la del primer turno)
+//   move     cada copia siguiente, en régimen (mediana de -r repeticiones)
+// "faults" son fallos de página menores de cada fase; "huge" y "lock" salen de
+// /proc/self/smaps del mapeo del jugador (Locked de páginas compartidas se reparte entre
+// los procesos que las mapean: con el máster vivo es la mitad del segmento).
+#define DEFAULT_BENCH_SIZE 2000
+#define DEFAULT_REPEATS 50
+#define BENCH_NAMESPACE_SIZE 32
+#define SMAPS_LINE_SIZE 256
+#define NS_PER_US 1000.0
+
+typedef struct
+{
+    const char *name;
+    int flags;
+} bench_mode_t;
+
+static const bench_mode_t modes[] = {
+    {"plain", 0},
+    {"prefault", SHM_FLAG_PREFAULT},
+    {"huge", SHM_FLAG_HUGEPAGES},
+    {"huge+pre", SHM_FLAG_HUGEPAGES | SHM_FLAG_PREFAULT},
+    {"mlock", SHM_FLAG_MLOCK},
+    {"all", SHM_FLAG_HUGEPAGES | SHM_FLAG_PREFAULT | SHM_FLAG_MLOCK},
+};
+#define MODE_COUNT (sizeof(modes) / sizeof(modes[0]))
+
+// Lo que mide el hijo, de vuelta por un pipe
+typedef struct
+{
+    uint64_t connect_ns;
+    long connect_faults;
+    uint64_t first_ns;
+    long first_faults;
+    uint64_t move_ns;
+    long huge_kb;
+    long locked_kb;
+} player_result_t;
+
+void print_usage_shmbench(const char *program_name)
+{
+    printf("Usage: %s [-w width] [-h height] [-r repeats]\n", program_name);
+    printf("  -w, -h : Board size (default: %dx%d)\n", DEFAULT_BENCH_SIZE, DEFAULT_BENCH_SIZE);
+    printf("  -r     : Board copies measured per mode after the first one (default: %d)\n", DEFAULT_REPEATS);
+}
+
+static long minor_faults(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Suma de los campos de smaps del mapeo que empieza en addr
+static void mapping_usage(const void *addr, long *huge_kb, long *locked_kb)
+{
+    *huge_kb = *locked_kb = 0;
+    FILE *smaps = fopen("/proc/self/smaps", "r");
+    if (!smaps)
+        return;
+
+    char line[SMAPS_LINE_SIZE];
+    bool inside = false;
+    while (fgets(line, sizeof(line), smaps))
+    {
+        unsigned long start, end;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2)
+        {
+            inside = start == (unsigned long)addr;
+            continue;
+        }
+        long kb;
+        if (!inside)
+            continue;
+        if (sscanf(line, "ShmemPmdMapped: %ld kB", &kb) == 1 || sscanf(line, "FilePmdMapped: %ld kB", &kb) == 1)
+            *huge_kb += kb;
+        else if (sscanf(line, "Locked: %ld kB", &kb) == 1)
+            *locked_kb += kb;
+    }
+    fclose(smaps);
+}
+
+// Hijo: conecta como un jugador y copia el tablero como en cada turno
+static void run_player(int width, int height, int repeats, int out_fd)
+{
+    player_result_t result = {0};
+    game_state_t *state;
+    game_sync_t *sync;
+
+    long faults = minor_faults();
+    uint64_t start = monotonic_ns();
+    if (connect_shared_memory(width, height, &state, &sync) != 0)
+        error_exit("connect_shared_memory");
+    result.connect_ns = monotonic_ns() - start;
+    result.connect_faults = minor_faults() - faults;
+
+    size_t bytes = sizeof(int) * BOARD_CELLS(width, height);
+    int *local = malloc(bytes);
+    uint64_t *samples = malloc(sizeof(uint64_t) * repeats);
+    if (!local || !samples)
+        error_exit("malloc");
+    memset(local, 1, bytes); // El buffer propio no entra en la medición (con 0 GCC lo vuelve calloc)
+
+    faults = minor_faults();
+    start = monotonic_ns();
+    memcpy(local, state->board, bytes);
+    result.first_ns = monotonic_ns() - start;
+    result.first_faults = minor_faults() - faults;
+
+    for (int r = 0; r < repeats; r++)
+    {
+        start = monotonic_ns();
+        memcpy(local, state->board, bytes);
+        samples[r] = monotonic_ns() - start;
+    }
+    qsort(samples, repeats, sizeof(uint64_t), compare_u64);
+    result.move_ns = samples[repeats / 2];
+    mapping_usage(state, &result.huge_kb, &result.locked_kb);
+
+    if (write_all(out_fd, &result, sizeof(result)) == -1)
+        error_exit("write result");
+    free(samples);
+    free(local);
+    cleanup_shared_memory(state, sync);
+    _exit(EXIT_SUCCESS);
+}
+
+static void run_mode(const bench_mode_t *mode, int width, int height, int repeats)
+{
+    game_state_t *state;
+    game_sync_t *sync;
+    board_gen_t gen = {.seed = 1, .rng = RNG_PHILOX, .profile = REWARD_UNIFORM, .threads = 1};
+
+    long faults = minor_faults();
+    uint64_t start = monotonic_ns();
+    if (create_shared_memory(width, height, 1, mode->flags, &state, &sync) != 0)
+        error_exit("create_shared_memory");
+    uint64_t create_ns = monotonic_ns() - start;
+    long create_faults = minor_faults() - faults;
+
+    faults = minor_faults();
+    start = monotonic_ns();
+    initialize_board(state, &gen);
+    uint64_t fill_ns = monotonic_ns() - start;
+    long fill_faults = minor_faults() - faults;
+
+    int fds[2];
+    if (pipe(fds) == -1)
+        error_exit("pipe");
+    pid_t pid = fork();
+    if (pid == -1)
+        error_exit("fork");
+    if (pid == 0)
+    {
+        close(fds[0]);
+        run_player(width, height, repeats, fds[1]);
+    }
+    close(fds[1]);
+
+    player_result_t result;
+    ssize_t got = read(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+    cleanup_shared_memory(state, sync);
+    unlink_shared_memory();
+    if (got != (ssize_t)sizeof(result))
+    {
+        printf("%-9s player failed\n", mode->name);
+        return;
+    }
+
+    printf("%-9s %8.2f %7ld %8.2f %7ld %8.2f %7ld %8.2f %7ld %9.1f %8ld %8ld\n", mode->name,
+           (double)create_ns / NS_PER_MS, create_faults, (double)fill_ns / NS_PER_MS, fill_faults,
+           (double)result.connect_ns / NS_PER_MS, result.connect_faults, (double)result.first_ns / NS_PER_MS,
+           result.first_faults, (double)result.move_ns / NS_PER_US, result.huge_kb, result.locked_kb);
+}
+
+static void print_thp_setting(void)
+{
+    char setting[SMAPS_LINE_SIZE] = "unavailable";
+    FILE *file = fopen("/sys/kernel/mm/transparent_hugepage/shmem_enabled", "r");
+    if (file)
+    {
+        if (!fgets(setting, sizeof(setting), file))
+            strcpy(setting, "unreadable");
+        fclose(file);
+    }
+    setting[strcspn(setting, "\n")] = '\0';
+    printf("shmem THP: %s\n", setting);
+}
+
+int main(int argc, char *argv[])
+{
+    int width = DEFAULT_BENCH_SIZE, height = DEFAULT_BENCH_SIZE, repeats = DEFAULT_REPEATS;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:h:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'h':
+            height = atoi(optarg);
+            break;
+        case 'r':
+            repeats = atoi(optarg);
+            break;
+        default:
+            print_usage_shmbench(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (width < MIN_BOARD_SIZE || height < MIN_BOARD_SIZE || repeats < 1)
+    {
+        print_usage_shmbench(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Segmentos propios: no pisa una partida que esté corriendo
+    char ns[BENCH_NAMESPACE_SIZE];
+    snprintf(ns, sizeof(ns), "shmbench%d", (int)getpid());
+    setenv(SHM_NAMESPACE_ENV, ns, 1);
+
+    size_t bytes = sizeof(int) * BOARD_CELLS(width, height);
+    printf("board %dx%d (%.1f MB), page %ld B\n", width, height, (double)bytes / (1 << 20), sysconf(_SC_PAGESIZE));
+    print_thp_setting();
+    printf("%-9s %8s %7s %8s %7s %8s %7s %8s %7s %9s %8s %8s\n", "mode", "map ms", "faults", "fill ms", "faults",
+           "conn ms", "faults", "first ms", "faults", "move us", "huge kB", "lock kB");
+    for (size_t i = 0; i < MODE_COUNT; i++)
+        run_mode(&modes[i], width, height, repeats);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "sim.h"
+#include "probes.h"
+
+// Estado en memoria privada con el mismo layout que el segmento compartido
+game_state_t *sim_state_alloc(int width, int height, unsigned int player_count)
+{
+    game_state_t *state = calloc(1, sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(width, height));
+    if (!state)
+        return NULL;
+    state->width = width;
+    state->height = height;
+    state->player_count = player_count;
+    return state;
+}
+
+// Usa un estado ya armado (tablero y jugadores colocados); solo reserva el estado de las estrategias
+int sim_game_attach(sim_game_t *game, game_state_t *state, const chomp_strategy_t *const strategies[])
+{
+    memset(game, 0, sizeof(*game));
+    game->state = state;
+    game->rules = rules_select(state->width, state->height);
+
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        game->strategies[i] = strategies[i];
+        if (strategies[i]->state_size)
+        {
+            game->strategy_state[i] = calloc(1, strategies[i]->state_size);
+            if (!game->strategy_state[i])
+            {
+                sim_game_destroy(game);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int sim_game_init(sim_game_t *game, int width, int height, unsigned int player_count, const board_gen_t *gen,
+                  const chomp_strategy_t *const strategies[])
+{
+    game_state_t *state = sim_state_alloc(width, height, player_count);
+    if (!state)
+        return -1;
+
+    // Un hilo por partida: el paralelismo está entre partidas, no dentro del tablero
+    board_gen_t single = *gen;
+    single.threads = 1;
+    initialize_board(state, &single);
+    place_players(state);
+
+    if (sim_game_attach(game, state, strategies) == -1)
+    {
+        free(state);
+        return -1;
+    }
+    game->owns_state = true;
+    return 0;
+}
+
+int sim_game_enable_index(sim_game_t *game)
+{
+    game->index = reward_index_alloc(game->state->width, game->state->height);
+    if (!game->index)
+        return -1;
+    reward_index_build(game->index, game->state);
+    game->owns_index = true;
+    return 0;
+}
+
+int sim_game_enable_endgame(sim_game_t *game, uint64_t time_limit_ns, poscache_t *cache)
+{
+    for (unsigned int i = 0; i < game->state->player_count; i++)
+    {
+        game->endgame[i] = malloc(sizeof(endgame_t));
+        if (!game->endgame[i])
+            return -1;
+        endgame_init(game->endgame[i], time_limit_ns);
+        game->endgame[i]->cache = cache;
+    }
+    return 0;
+}
+
+// Un turno de un jugador no bloqueado: decide, aplica y marca el fin si nadie más puede moverse
+sim_turn_t sim_play_turn(sim_game_t *game, unsigned int player_id, unsigned char *move)
+{
+    game_state_t *state = game->state;
+    board_view_t board = {state->board, state->width, state->height, state->player_count, game->index};
+
+    player_t me;
+    get_player(state, player_id, &me);
+    bool planned = false;
+    if (game->endgame[player_id])
+    {
+        player_t players[MAX_PLAYERS];
+        for (unsigned int i = 0; i < state->player_count; i++)
+            get_player(state, i, &players[i]);
+        planned = endgame_next_move(game->endgame[player_id], &board, player_id, players, move);
+    }
+    if (!planned)
+        *move = game->strategies[player_id]->choose(&board, &me, game->strategy_state[player_id]);
+
+    if (*move == STRATEGY_NO_MOVE)
+    {
+        PLAYER_BLOCKED(state, player_id) = true;
+        CHOMP_PROBE1(player_blocked, player_id);
+        if (game->rules->game_over(state))
+            state->game_finished = true;
+        return SIM_TURN_GAVE_UP;
+    }
+
+    unsigned int score_before = PLAYER_SCORE(state, player_id);
+    bool valid = game->rules->process_move(state, player_id, *move);
+    if (valid && game->index)
+        reward_index_consume(game->index, PLAYER_X(state, player_id), PLAYER_Y(state, player_id),
+                             PLAYER_SCORE(state, player_id) - score_before);
+    if (game->rules->game_over(state))
+        state->game_finished = true;
+    return valid ? SIM_TURN_VALID : SIM_TURN_INVALID;
+}
+
+// Juega hasta el final. Sin reloj: el timeout del máster se reemplaza por un límite de rondas
+// sin movimientos válidos, así el resultado depende solo del seed y las estrategias.
+void sim_game_run(sim_game_t *game, sim_result_t *result)
+{
+    game_state_t *state = game->state;
+    memset(result, 0, sizeof(*result));
+    unsigned int stalled_rounds = 0;
+
+    while (!state->game_finished)
+    {
+        bool any_valid = false;
+        for (unsigned int i = 0; i < state->player_count && !state->game_finished; i++)
+        {
+            if (PLAYER_BLOCKED(state, i))
+                continue;
+
+            unsigned char move;
+            sim_turn_t turn = sim_play_turn(game, i, &move);
+            if (turn == SIM_TURN_VALID)
+            {
+                result->valid_moves++;
+                any_valid = true;
+            }
+            else if (turn == SIM_TURN_INVALID)
+            {
+                result->invalid_moves++;
+            }
+        }
+        result->rounds++;
+
+        stalled_rounds = any_valid ? 0 : stalled_rounds + 1;
+        if (stalled_rounds >= SIM_MAX_STALL_ROUNDS)
+            state->game_finished = true;
+    }
+
+    result->winner = find_winner(state);
+}
+
+void sim_game_destroy(sim_game_t *game)
+{
+    for (unsigned int i = 0; i < MAX_PLAYERS; i++)
+    {
+        free(game->strategy_state[i]);
+        if (game->endgame[i])
+        {
+            endgame_destroy(game->endgame[i]);
+            free(game->endgame[i]);
+        }
+    }
+    if (game->owns_state)
+        free(game->state);
+    if (game->owns_index)
+        free(game->index);
+    memset(game, 0, sizeof(*game));
+}
@@ -0,0 +1,55 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "common.h"
+#include "board_gen.h"
+#include "strategy.h"
+#include "rules.h"
+#include "endgame.h"
+
+// Partida sin procesos ni memoria compartida: todo el estado vive en sim_game_t, así que
+// cualquier cantidad de partidas puede correr en paralelo en el mismo proceso (una por hilo).
+// Usa las mismas reglas que el máster (rules_select, find_winner).
+#define SIM_MAX_STALL_ROUNDS 16 // Rondas seguidas sin movimientos válidos antes de cortar
+
+typedef enum
+{
+    SIM_TURN_VALID = 0,
+    SIM_TURN_INVALID,
+    SIM_TURN_GAVE_UP // La estrategia devolvió STRATEGY_NO_MOVE: el jugador queda bloqueado
+} sim_turn_t;
+
+typedef struct
+{
+    game_state_t *state;
+    bool owns_state; // false si state es, por ejemplo, el segmento compartido del máster
+    const chomp_strategy_t *strategies[MAX_PLAYERS];
+    void *strategy_state[MAX_PLAYERS];
+    reward_index_t *index; // Opcional: se pasa a las estrategias y se actualiza en cada movimiento
+    bool owns_index;
+    const rule_kernels_t *rules; // Según las dimensiones, ver rules.h
+    endgame_t *endgame[MAX_PLAYERS]; // Opcional: solver de final antes de cada estrategia
+} sim_game_t;
+
+typedef struct
+{
+    uint64_t valid_moves;
+    uint64_t invalid_moves;
+    uint64_t rounds;
+    int winner;
+} sim_result_t;
+
+game_state_t *sim_state_alloc(int width, int height, unsigned int player_count);
+int sim_game_init(sim_game_t *game, int width, int height, unsigned int player_count, const board_gen_t *gen,
+                  const chomp_strategy_t *const strategies[]);
+int sim_game_attach(sim_game_t *game, game_state_t *state, const chomp_strategy_t *const strategies[]);
+// Mantiene un índice de recompensa propio (reward_index.h) durante la partida
+int sim_game_enable_index(sim_game_t *game);
+// Cada jugador resuelve el final al quedar aislado (endgame.h); con time_limit_ns = 0 la
+// partida sigue dependiendo solo del seed. cache puede ser NULL; la comparten todas las partidas.
+int sim_game_enable_endgame(sim_game_t *game, uint64_t time_limit_ns, poscache_t *cache);
+sim_turn_t sim_play_turn(sim_game_t *game, unsigned int player_id, unsigned char *move);
+void sim_game_run(sim_game_t *game, sim_result_t *result);
+void sim_game_destroy(sim_game_t *game);
+
+#endif
@@ -0,0 +1,392 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "sim.h"
+#include <pthread.h>
+
+// Motor de simulación headless: corre miles de partidas independientes (sim.h) en un pool
+// de hilos con work stealing y agrega los resultados por estrategia. El resultado de cada
+// partida depende solo de su seed y de la rotación de asientos, no de qué hilo la jugó.
+#define DEFAULT_SIM_GAMES 1000
+#define MAX_SIM_STRATEGIES MAX_PLAYERS
+
+typedef struct
+{
+    int threads;
+    unsigned long games;
+    unsigned int first_seed;
+    int width;
+    int height;
+    board_gen_t board_gen;
+    bool reward_index; // -I: mantener el índice de recompensa (strategy region lo usa)
+    bool endgame;      // -E: solver de final (endgame.h) delante de cada estrategia
+    char **strategy_args;
+    int strategy_count;
+} sim_config_t;
+
+typedef struct
+{
+    unsigned long games;
+    unsigned long wins;
+    double score_sum;
+} sim_strategy_stats_t;
+
+// Cola de un worker: rango [next, end) de índices de partida. El dueño consume desde next,
+// los ladrones se llevan la mitad de arriba achicando end. Las partidas duran mucho más que
+// tomar el mutex, así que un lock por cola alcanza (no hace falta una deque lock-free).
+typedef struct
+{
+    pthread_mutex_t lock;
+    unsigned long next;
+    unsigned long end;
+
+    // Resultados propios, se suman al final (sin contención entre hilos)
+    unsigned long played;
+    unsigned long failed;
+    unsigned long steals;
+    uint64_t valid_moves;
+    uint64_t invalid_moves;
+    uint64_t rounds;
+    uint64_t checksum;
+    sim_strategy_stats_t stats[MAX_SIM_STRATEGIES];
+} worker_t;
+
+typedef struct
+{
+    const sim_config_t *config;
+    const chomp_strategy_t *strategies[MAX_SIM_STRATEGIES];
+    worker_t *workers;
+    poscache_t *cache; // CHOMP_POSCACHE con -E: compartida por todos los hilos
+} sim_pool_t;
+
+typedef struct
+{
+    sim_pool_t *pool;
+    int id;
+} worker_arg_t;
+
+static loaded_strategy_t plugins[MAX_SIM_STRATEGIES];
+
+void print_usage_simulate(const char *program_name)
+{
+    printf("Usage: %s [-j threads] [-n games] [-S first_seed] [-w width] [-h height] [-P profile] [-I] [-E] "
+           "strategy1 [strategy2 ...]\n", program_name);
+    printf("  -j threads : Worker threads (default: one per CPU)\n");
+    printf("  -n games   : Games to simulate (default: %d)\n", DEFAULT_SIM_GAMES);
+    printf("  -S seed    : First seed; game i uses first_seed + i (default: 1)\n");
+    printf("  -P profile : Reward profile: uniform, clustered, gradient (default: uniform)\n");
+    printf("  -I         : Maintain a reward index per game (region queries in O(log W * log H))\n");
+    printf("  -E         : Solve the endgame once a player is isolated (no time limit, stays deterministic)\n");
+    printf("Every game seats all strategies, rotated by one seat per game.\n");
+    printf("With -E, %s=<file> keeps solved endgames in a cache shared across runs.\n", POSCACHE_ENV);
+    printf("A strategy is a built-in name (greedy, perimeter, region) or a plugin .so path.\n");
+}
+
+void parse_arguments(int argc, char *argv[], sim_config_t *config)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    config->threads = cpus > 0 ? (int)cpus : 1;
+    config->games = DEFAULT_SIM_GAMES;
+    config->first_seed = 1;
+    config->width = DEFAULT_WIDTH;
+    config->height = DEFAULT_HEIGHT;
+    config->board_gen.rng = RNG_PHILOX;
+    config->board_gen.profile = REWARD_UNIFORM;
+    config->board_gen.threads = 1;
+    config->reward_index = false;
+    config->endgame = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:n:S:w:h:P:IE")) != -1)
+    {
+        switch (opt)
+        {
+        case 'j':
+            config->threads = atoi(optarg);
+            break;
+        case 'n':
+            config->games = strtoul(optarg, NULL, 10);
+            break;
+        case 'S':
+            config->first_seed = (unsigned int)atoi(optarg);
+            break;
+        case 'w':
+            config->width = atoi(optarg);
+            break;
+        case 'h':
+            config->height = atoi(optarg);
+            break;
+        case 'P':
+            if (parse_reward_profile(optarg, &config->board_gen.profile) == -1)
+            {
+                fprintf(stderr, "Unknown reward profile '%s' (uniform, clustered, gradient)\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'I':
+            config->reward_index = true;
+            break;
+        case 'E':
+            config->endgame = true;
+            break;
+        default:
+            print_usage_simulate(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    config->strategy_args = &argv[optind];
+    config->strategy_count = argc - optind;
+
+    if (config->strategy_count < 1 || config->strategy_count > MAX_SIM_STRATEGIES || config->threads < 1 ||
+        config->games < 1 || config->width < MIN_BOARD_SIZE || config->height < MIN_BOARD_SIZE)
+    {
+        print_usage_simulate(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Juega la partida index: seed first_seed + index, asientos rotados index posiciones
+void play_game(sim_pool_t *pool, worker_t *self, unsigned long index)
+{
+    const sim_config_t *config = pool->config;
+    int count = config->strategy_count;
+
+    int seats[MAX_PLAYERS];
+    const chomp_strategy_t *seated[MAX_PLAYERS];
+    for (int i = 0; i < count; i++)
+    {
+        seats[i] = (int)((i + index) % count);
+        seated[i] = pool->strategies[seats[i]];
+    }
+
+    board_gen_t gen = config->board_gen;
+    gen.seed = config->first_seed + (unsigned int)index;
+
+    sim_game_t game;
+    if (sim_game_init(&game, config->width, config->height, count, &gen, seated) == -1)
+    {
+        self->failed++;
+        return;
+    }
+    if ((config->reward_index && sim_game_enable_index(&game) == -1) ||
+        (config->endgame && sim_game_enable_endgame(&game, 0, pool->cache) == -1))
+    {
+        sim_game_destroy(&game);
+        self->failed++;
+        return;
+    }
+
+    sim_result_t result;
+    sim_game_run(&game, &result);
+
+    self->played++;
+    self->valid_moves += result.valid_moves;
+    self->invalid_moves += result.invalid_moves;
+    self->rounds += result.rounds;
+    for (int i = 0; i < count; i++)
+    {
+        sim_strategy_stats_t *s = &self->stats[seats[i]];
+        s->games++;
+        s->score_sum += PLAYER_SCORE(game.state, i);
+        if (i == result.winner)
+            s->wins++;
+        // Suma independiente del orden: sirve para comparar corridas con distinta cantidad de hilos
+        self->checksum += (uint64_t)(index + 1) * (PLAYER_SCORE(game.state, i) + 1) * (uint64_t)(seats[i] + 1);
+    }
+
+    sim_game_destroy(&game);
+}
+
+// Próxima partida de la cola propia; false si está vacía
+static bool pop_own(worker_t *self, unsigned long *index)
+{
+    pthread_mutex_lock(&self->lock);
+    bool found = self->next < self->end;
+    if (found)
+    {
+        *index = self->next;
+        __atomic_store_n(&self->next, *index + 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&self->lock);
+    return found;
+}
+
+// Roba la mitad de la cola con más trabajo pendiente; false si no queda nada en ninguna
+static bool steal(sim_pool_t *pool, int self_id)
+{
+    worker_t *self = &pool->workers[self_id];
+    int threads = pool->config->threads;
+
+    for (;;)
+    {
+        // Elegir víctima sin lock: es solo una heurística, se revalida con el lock tomado
+        int victim = -1;
+        unsigned long best = 0;
+        for (int i = 0; i < threads; i++)
+        {
+            if (i == self_id)
+                continue;
+            worker_t *w = &pool->workers[i];
+            unsigned long next = __atomic_load_n(&w->next, __ATOMIC_RELAXED);
+            unsigned long end = __atomic_load_n(&w->end, __ATOMIC_RELAXED);
+            if (end > next && end - next > best)
+            {
+                best = end - next;
+                victim = i;
+            }
+        }
+        if (victim == -1)
+            return false;
+
+        worker_t *w = &pool->workers[victim];
+        pthread_mutex_lock(&w->lock);
+        unsigned long remaining = w->end > w->next ? w->end - w->next : 0;
+        if (remaining == 0)
+        {
+            pthread_mutex_unlock(&w->lock);
+            continue; // Otro ladrón (o el dueño) llegó antes
+        }
+        unsigned long take = (remaining + 1) / 2;
+        unsigned long first = w->end - take;
+        __atomic_store_n(&w->end, first, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&w->lock);
+
+        pthread_mutex_lock(&self->lock);
+        __atomic_store_n(&self->next, first, __ATOMIC_RELAXED);
+        __atomic_store_n(&self->end, first + take, __ATOMIC_RELAXED);
+        self->steals++;
+        pthread_mutex_unlock(&self->lock);
+        return true;
+    }
+}
+
+void *worker_main(void *arg)
+{
+    worker_arg_t *worker = arg;
+    sim_pool_t *pool = worker->pool;
+    worker_t *self = &pool->workers[worker->id];
+
+    for (;;)
+    {
+        unsigned long index;
+        if (pop_own(self, &index))
+            play_game(pool, self, index);
+        else if (!steal(pool, worker->id))
+            break;
+    }
+    return NULL;
+}
+
+void print_report(const sim_config_t *config, const sim_pool_t *pool, double elapsed)
+{
+    unsigned long played = 0, failed = 0;
+    uint64_t valid = 0, invalid = 0, rounds = 0, checksum = 0;
+    sim_strategy_stats_t stats[MAX_SIM_STRATEGIES];
+    memset(stats, 0, sizeof(stats));
+
+    for (int t = 0; t < config->threads; t++)
+    {
+        const worker_t *w = &pool->workers[t];
+        played += w->played;
+        failed += w->failed;
+        valid += w->valid_moves;
+        invalid += w->invalid_moves;
+        rounds += w->rounds;
+        checksum += w->checksum;
+        for (int i = 0; i < config->strategy_count; i++)
+        {
+            stats[i].games += w->stats[i].games;
+            stats[i].wins += w->stats[i].wins;
+            stats[i].score_sum += w->stats[i].score_sum;
+        }
+    }
+
+    uint64_t moves = valid + invalid;
+    printf("%lu games (%lu failed) on %d threads in %.3f s: %.1f games/s, %.0f moves/s\n", played, failed,
+           config->threads, elapsed, elapsed > 0 ? played / elapsed : 0.0, elapsed > 0 ? moves / elapsed : 0.0);
+    printf("moves=%lu invalid=%lu rounds=%lu checksum=%016lx\n", (unsigned long)moves, (unsigned long)invalid,
+           (unsigned long)rounds, (unsigned long)checksum);
+    printf("%-32s %8s %8s %10s\n", "strategy", "games", "win%", "avg score");
+    for (int i = 0; i < config->strategy_count; i++)
+    {
+        const sim_strategy_stats_t *s = &stats[i];
+        printf("%-32s %8lu %7.1f%% %10.1f\n", config->strategy_args[i], s->games,
+               s->games ? 100.0 * s->wins / s->games : 0.0, s->games ? s->score_sum / s->games : 0.0);
+    }
+    if (pool->cache)
+    {
+        const poscache_header_t *h = pool->cache->header;
+        printf("poscache: %lu entries, %lu hits, %lu misses, %lu failed inserts, arena %.1f%%\n",
+               (unsigned long)h->entries, (unsigned long)h->hits, (unsigned long)h->misses,
+               (unsigned long)h->failed_inserts,
+               100.0 * (h->arena_used < h->arena_bytes ? h->arena_used : h->arena_bytes) / h->arena_bytes);
+    }
+    printf("%-8s %8s %8s\n", "thread", "games", "steals");
+    for (int t = 0; t < config->threads; t++)
+        printf("%-8d %8lu %8lu\n", t, pool->workers[t].played, pool->workers[t].steals);
+}
+
+int main(int argc, char *argv[])
+{
+    sim_config_t config;
+    parse_arguments(argc, argv, &config);
+    if ((unsigned long)config.threads > config.games)
+        config.threads = (int)config.games;
+
+    sim_pool_t pool = {.config = &config};
+    for (int i = 0; i < config.strategy_count; i++)
+    {
+        pool.strategies[i] = strategy_resolve(config.strategy_args[i], &plugins[i]);
+        if (!pool.strategies[i])
+        {
+            fprintf(stderr, "Unknown strategy '%s'\n", config.strategy_args[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (config.endgame)
+        pool.cache = poscache_open_from_env();
+
+    pool.workers = calloc(config.threads, sizeof(worker_t));
+    worker_arg_t *args = calloc(config.threads, sizeof(worker_arg_t));
+    pthread_t *threads = calloc(config.threads, sizeof(pthread_t));
+    if (!pool.workers || !args || !threads)
+        error_exit("calloc workers");
+
+    // Reparto inicial en rangos contiguos; el stealing corrige el desbalance (tableros
+    // o estrategias que hacen partidas más largas)
+    for (int t = 0; t < config.threads; t++)
+    {
+        pthread_mutex_init(&pool.workers[t].lock, NULL);
+        pool.workers[t].next = config.games * t / config.threads;
+        pool.workers[t].end = config.games * (t + 1) / config.threads;
+        args[t].pool = &pool;
+        args[t].id = t;
+    }
+
+    uint64_t start = monotonic_ns();
+    int started = 0;
+    for (int t = 1; t < config.threads; t++)
+    {
+        if (pthread_create(&threads[t], NULL, worker_main, &args[t]) != 0)
+            break;
+        started = t;
+    }
+    worker_main(&args[0]); // El hilo principal también trabaja
+    for (int t = 1; t <= started; t++)
+        pthread_join(threads[t], NULL);
+    double elapsed = (double)(monotonic_ns() - start) / NS_PER_SECOND;
+
+    print_report(&config, &pool, elapsed);
+
+    for (int t = 0; t < config.threads; t++)
+        pthread_mutex_destroy(&pool.workers[t].lock);
+    for (int i = 0; i < config.strategy_count; i++)
+        strategy_unload(&plugins[i]);
+    poscache_close(pool.cache);
+    free(threads);
+    free(args);
+    free(pool.workers);
+    return EXIT_SUCCESS;
+}
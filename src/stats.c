@@ -0,0 +1,154 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "stats.h"
+
+#define STATS_MEMFD_NAME "game_stats"
+#define STATS_MEMFD_LINK "/memfd:" STATS_MEMFD_NAME
+#define PROC_FD_DIR_SIZE 32
+
+// En modo memfd el descriptor queda abierto en el máster para que chompstat -p lo
+// encuentre en /proc/<pid>/fd; con nombre se cierra enseguida.
+static int stats_memfd = INVALID_FD;
+
+// Crea el segmento; si falla el juego sigue sin estadísticas (STATS_* ignora NULL)
+game_stats_t *stats_create(unsigned int player_count, int shm_flags)
+{
+    bool memfd = shm_flags & SHM_FLAG_MEMFD;
+    int fd = memfd ? memfd_create(STATS_MEMFD_NAME, MFD_CLOEXEC)
+                   : shm_open_ns(GAME_STATS_SHM, O_CREAT | O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1)
+        return NULL;
+
+    if (ftruncate(fd, sizeof(game_stats_t)) == -1)
+    {
+        close(fd);
+        if (!memfd)
+            shm_unlink_ns(GAME_STATS_SHM);
+        return NULL;
+    }
+
+    game_stats_t *stats = mmap(NULL, sizeof(game_stats_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memfd && stats != MAP_FAILED)
+        stats_memfd = fd;
+    else
+        close(fd);
+    if (stats == MAP_FAILED)
+    {
+        if (!memfd)
+            shm_unlink_ns(GAME_STATS_SHM);
+        return NULL;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->player_count = player_count;
+    stats->start_ns = monotonic_ns();
+    stats->updated_ns = stats->start_ns;
+    __atomic_store_n(&stats->magic, STATS_MAGIC, __ATOMIC_RELEASE);
+    return stats;
+}
+
+void stats_destroy(game_stats_t *stats)
+{
+    if (!stats)
+        return;
+    munmap(stats, sizeof(game_stats_t));
+    if (stats_memfd != INVALID_FD)
+    {
+        close(stats_memfd);
+        stats_memfd = INVALID_FD;
+    }
+    else
+    {
+        shm_unlink_ns(GAME_STATS_SHM);
+    }
+}
+
+// Busca el memfd de estadísticas entre los descriptores abiertos del máster
+static int open_stats_of_pid(pid_t pid)
+{
+    char dir_path[PROC_FD_DIR_SIZE];
+    snprintf(dir_path, sizeof(dir_path), "/proc/%d/fd", (int)pid);
+
+    DIR *dir = opendir(dir_path);
+    if (!dir)
+        return -1;
+
+    int fd = -1;
+    struct dirent *entry;
+    while (fd == -1 && (entry = readdir(dir)) != NULL)
+    {
+        char link_path[PATH_MAX], target[PATH_MAX];
+        snprintf(link_path, sizeof(link_path), "%s/%s", dir_path, entry->d_name);
+        ssize_t len = readlink(link_path, target, sizeof(target) - 1);
+        if (len <= 0)
+            continue;
+        target[len] = '\0';
+        if (strncmp(target, STATS_MEMFD_LINK, strlen(STATS_MEMFD_LINK)) == 0)
+            fd = open(link_path, O_RDONLY);
+    }
+    closedir(dir);
+
+    if (fd == -1)
+        errno = ENOENT;
+    return fd;
+}
+
+// pid > 0: segmento memfd de ese máster; si no, el segmento con nombre del namespace actual
+game_stats_t *stats_open_readonly(pid_t pid)
+{
+    int fd = pid > 0 ? open_stats_of_pid(pid) : shm_open_ns(GAME_STATS_SHM, O_RDONLY, 0);
+    if (fd == -1)
+        return NULL;
+
+    game_stats_t *stats = mmap(NULL, sizeof(game_stats_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED)
+        return NULL;
+
+    if (__atomic_load_n(&stats->magic, __ATOMIC_ACQUIRE) != STATS_MAGIC)
+    {
+        munmap(stats, sizeof(game_stats_t));
+        errno = EINVAL;
+        return NULL;
+    }
+    return stats;
+}
+
+void stats_close(game_stats_t *stats)
+{
+    if (stats)
+        munmap(stats, sizeof(game_stats_t));
+}
+
+void stats_record_latency(game_stats_t *stats, unsigned int player_id, uint64_t latency_ns)
+{
+    if (!stats || player_id >= MAX_PLAYERS)
+        return;
+
+    // Índice del bit más alto = log2 de la latencia
+    unsigned int bucket = latency_ns ? 63 - __builtin_clzll(latency_ns) : 0;
+    if (bucket >= LATENCY_BUCKETS)
+        bucket = LATENCY_BUCKETS - 1;
+
+    STATS_ADD(stats, latency_count[player_id], 1);
+    STATS_ADD(stats, latency_sum_ns[player_id], latency_ns);
+    STATS_ADD(stats, latency_hist[player_id][bucket], 1);
+}
+
+// Percentil aproximado: devuelve el límite superior del bucket que lo contiene
+uint64_t stats_latency_percentile(const game_stats_t *stats, unsigned int player_id, double percentile)
+{
+    uint64_t total = STATS_LOAD(stats, latency_count[player_id]);
+    if (total == 0)
+        return 0;
+
+    uint64_t target = (uint64_t)(total * percentile);
+    uint64_t seen = 0;
+    for (unsigned int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+        seen += STATS_LOAD(stats, latency_hist[player_id][bucket]);
+        if (seen > target)
+            return 2ULL << bucket;
+    }
+    return 2ULL << (LATENCY_BUCKETS - 1);
+}
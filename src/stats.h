@@ -0,0 +1,78 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "common.h"
+
+// Segmento de estadísticas en vivo. Lo escribe solo el máster, con atómicos relajados
+// (sin lock prefix, hay un único escritor); cualquier otro proceso lo mapea de solo
+// lectura y lo muestrea sin tomar ninguno de los semáforos del juego.
+#define GAME_STATS_SHM "/game_stats"
+#define STATS_MAGIC 0x43485354u // "CHST"
+#define LATENCY_BUCKETS 40      // Bucket i: latencias en [2^i, 2^(i+1)) ns
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t player_count;
+    uint64_t start_ns;       // CLOCK_MONOTONIC al crear el segmento
+    uint64_t updated_ns;     // Última actualización del máster
+    uint64_t game_finished;
+
+    uint64_t moves_processed; // Movimientos leídos y pasados a process_move
+    uint64_t invalid_moves;
+
+    uint64_t select_calls;
+    uint64_t select_ns;     // Tiempo bloqueado en select()
+    uint64_t idle_ns;       // Parte de select_ns en la que no llegó ningún movimiento
+    uint64_t state_wait_ns; // Esperando state_mutex
+    uint64_t state_hold_ns; // Dentro de secciones críticas de state_mutex
+    uint64_t notify_calls;
+    uint64_t notify_view_ns; // En notify_view() (post + espera a la vista)
+    uint64_t sleep_ns;       // En usleep() por el delay configurado
+
+    // Arranque (medido desde que empezó el proceso máster)
+    uint64_t spawn_ns;       // Hasta terminar de lanzar vista y jugadores
+    uint64_t setup_ns;       // Hasta tener el tablero listo y el lock liberado
+    uint64_t first_move_ns;  // Hasta leer el primer movimiento de cualquier jugador
+
+    // Latencia de decisión: desde que el máster habilita al jugador hasta que lee su movimiento
+    // (incluye el tiempo que el movimiento esperó en el pipe mientras el máster atendía a otros)
+    uint64_t latency_count[MAX_PLAYERS];
+    uint64_t latency_sum_ns[MAX_PLAYERS];
+    uint64_t latency_hist[MAX_PLAYERS][LATENCY_BUCKETS];
+
+    // Cola de listos del game loop (scheduler.h): espera desde que select vio el movimiento
+    // hasta atenderlo, y el máximo de movimientos ajenos atendidos mientras esperaba
+    uint64_t sched_policy;
+    uint64_t sched_served[MAX_PLAYERS];
+    uint64_t sched_wait_sum_ns[MAX_PLAYERS];
+    uint64_t sched_wait_max_ns[MAX_PLAYERS];
+    uint64_t sched_max_bypass[MAX_PLAYERS];
+} game_stats_t;
+
+// Único escritor: load + store relajados alcanzan y evitan la instrucción atómica con lock
+#define STATS_ADD(stats, field, value)                                                                  \
+    do                                                                                                  \
+    {                                                                                                   \
+        if (stats)                                                                                      \
+            __atomic_store_n(&(stats)->field, __atomic_load_n(&(stats)->field, __ATOMIC_RELAXED) + (value), \
+                             __ATOMIC_RELAXED);                                                         \
+    } while (0)
+
+#define STATS_SET(stats, field, value)                                  \
+    do                                                                  \
+    {                                                                   \
+        if (stats)                                                      \
+            __atomic_store_n(&(stats)->field, (value), __ATOMIC_RELAXED); \
+    } while (0)
+
+#define STATS_LOAD(stats, field) __atomic_load_n(&(stats)->field, __ATOMIC_RELAXED)
+
+game_stats_t *stats_create(unsigned int player_count, int shm_flags);
+void stats_destroy(game_stats_t *stats);
+game_stats_t *stats_open_readonly(pid_t pid);
+void stats_close(game_stats_t *stats);
+void stats_record_latency(game_stats_t *stats, unsigned int player_id, uint64_t latency_ns);
+uint64_t stats_latency_percentile(const game_stats_t *stats, unsigned int player_id, double percentile);
+
+#endif
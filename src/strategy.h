@@ -0,0 +1,63 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "common.h"
+#include "reward_index.h"
+
+// ABI de estrategias: una estrategia es una función pura sobre una vista de solo lectura
+// del tablero. La usa el player (linkeada estáticamente) y el máster en modo --inproc,
+// que carga cada estrategia con dlopen desde un .so y la llama directo desde el game loop.
+// Un plugin exporta un chomp_strategy_t con el nombre CHOMP_STRATEGY_SYMBOL. choose() no debe
+// escribir en stdout/stderr: en simulación se llama millones de veces.
+#define CHOMP_STRATEGY_ABI_VERSION 1
+#define CHOMP_STRATEGY_SYMBOL "chomp_strategy"
+#define STRATEGY_NO_MOVE 0xFF // La estrategia se rinde: el jugador deja de mover
+
+// Tablero de solo lectura: celdas en el layout de game_state_t.board (BOARD_INDEX).
+// index es opcional (NULL si el host no lo mantiene); al estar al final, los plugins
+// compilados antes de agregarlo siguen funcionando.
+typedef struct
+{
+    const int *cells;
+    int width;
+    int height;
+    unsigned int player_count;
+    const reward_index_t *index; // Recompensa restante por rectángulo
+} board_view_t;
+
+typedef struct
+{
+    uint32_t abi_version; // CHOMP_STRATEGY_ABI_VERSION
+    const char *name;
+    size_t state_size;    // Estado privado por jugador; el host lo entrega en cero
+    unsigned char (*choose)(const board_view_t *board, const player_t *me, void *state);
+} chomp_strategy_t;
+
+// En un plugin (-DCHOMP_PLUGIN) exporta la estrategia con el símbolo que busca el host
+#ifdef CHOMP_PLUGIN
+#define CHOMP_EXPORT_STRATEGY(sym) \
+    extern const chomp_strategy_t chomp_strategy __attribute__((alias(#sym), visibility("default")));
+#else
+#define CHOMP_EXPORT_STRATEGY(sym)
+#endif
+
+// Estrategias incluidas (strategy_*.c)
+extern const chomp_strategy_t greedy_strategy;
+extern const chomp_strategy_t perimeter_strategy;
+extern const chomp_strategy_t region_strategy;
+
+// Estrategia cargada con dlopen (strategy_host.c). El estado privado lo reserva quien la
+// juega (una copia por partida), no el loader.
+typedef struct
+{
+    void *handle;
+    const chomp_strategy_t *strategy;
+} loaded_strategy_t;
+
+int strategy_load(const char *path, loaded_strategy_t *out);
+// Nombre de una estrategia incluida o ruta a un plugin; en los dos casos deja la estrategia
+// en out->strategy (handle NULL si es incluida). NULL si no se pudo cargar.
+const chomp_strategy_t *strategy_resolve(const char *name, loaded_strategy_t *out);
+void strategy_unload(loaded_strategy_t *loaded);
+
+#endif
@@ -0,0 +1,46 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "strategy.h"
+
+// busca en todas las direcciones el mejor reward y se mueve hacia ahi (greedy)
+static unsigned char greedy_choose(const board_view_t *board, const player_t *me, void *state)
+{
+    (void)state;
+    unsigned char best_move = 0;
+    int best_reward = -1;
+
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int dx, dy;
+        get_direction_offset(dir, &dx, &dy);
+
+        int new_x = me->x + dx;
+        int new_y = me->y + dy;
+
+        // Validar límites
+        if (new_x < 0 || new_x >= board->width || new_y < 0 || new_y >= board->height)
+            continue;
+
+        int cell_value = board->cells[BOARD_INDEX(board->width, new_x, new_y)];
+
+        // Verificar si la celda está libre (valor positivo = recompensa)
+        if (cell_value >= MIN_REWARD && cell_value <= MAX_REWARD)
+        {
+            if (cell_value > best_reward)
+            {
+                best_reward = cell_value;
+                best_move = dir;
+            }
+        }
+    }
+
+    return best_move;
+}
+
+const chomp_strategy_t greedy_strategy = {
+    .abi_version = CHOMP_STRATEGY_ABI_VERSION,
+    .name = "greedy",
+    .state_size = 0,
+    .choose = greedy_choose,
+};
+CHOMP_EXPORT_STRATEGY(greedy_strategy)
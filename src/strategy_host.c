@@ -0,0 +1,56 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "strategy.h"
+#include <dlfcn.h>
+
+// Carga un plugin de estrategia. -1 si falla (mensaje en stderr).
+int strategy_load(const char *path, loaded_strategy_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    // RTLD_LOCAL: cada plugin exporta el mismo símbolo, no deben pisarse entre sí
+    out->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!out->handle)
+    {
+        fprintf(stderr, "dlopen: %s\n", dlerror());
+        return -1;
+    }
+
+    out->strategy = dlsym(out->handle, CHOMP_STRATEGY_SYMBOL);
+    if (!out->strategy)
+    {
+        fprintf(stderr, "%s: missing symbol '%s'\n", path, CHOMP_STRATEGY_SYMBOL);
+        strategy_unload(out);
+        return -1;
+    }
+    if (out->strategy->abi_version != CHOMP_STRATEGY_ABI_VERSION || !out->strategy->choose)
+    {
+        fprintf(stderr, "%s: unsupported strategy ABI %u (expected %d)\n", path,
+                out->strategy->abi_version, CHOMP_STRATEGY_ABI_VERSION);
+        strategy_unload(out);
+        return -1;
+    }
+    return 0;
+}
+
+const chomp_strategy_t *strategy_resolve(const char *name, loaded_strategy_t *out)
+{
+    static const chomp_strategy_t *const builtin[] = {&greedy_strategy, &perimeter_strategy, &region_strategy};
+    for (size_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++)
+    {
+        if (strcmp(name, builtin[i]->name) == 0)
+        {
+            memset(out, 0, sizeof(*out));
+            out->strategy = builtin[i];
+            return builtin[i];
+        }
+    }
+    return strategy_load(name, out) == 0 ? out->strategy : NULL;
+}
+
+void strategy_unload(loaded_strategy_t *loaded)
+{
+    if (loaded->handle)
+        dlclose(loaded->handle);
+    memset(loaded, 0, sizeof(*loaded));
+}
@@ -0,0 +1,121 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "strategy.h"
+
+// Estado single-player: recorrido de perímetros (clockwise) dynamic
+typedef struct
+{
+    int initialized;
+    int finished;
+    unsigned int turn;
+    unsigned char dir; // dirección cardinal actual
+} perimeter_state_t;
+
+static inline int sp_cell_free(const board_view_t *board, int x, int y)
+{
+    if (x < 0 || x >= board->width || y < 0 || y >= board->height)
+        return 0;
+    int v = board->cells[BOARD_INDEX(board->width, x, y)];
+    return (v >= MIN_REWARD && v <= MAX_REWARD);
+}
+
+static int sp_can_move_dir(const board_view_t *board, int x, int y, unsigned char dir)
+{
+    int dx, dy;
+    get_direction_offset(dir, &dx, &dy);
+    return sp_cell_free(board, x + dx, y + dy);
+}
+
+static unsigned char sp_turn_left(unsigned char d)
+{
+    switch (d)
+    {
+    case DIR_UP:
+        return DIR_LEFT;
+    case DIR_LEFT:
+        return DIR_DOWN;
+    case DIR_DOWN:
+        return DIR_RIGHT;
+    default:
+        return DIR_UP; // DIR_RIGHT
+    }
+}
+static unsigned char sp_turn_right(unsigned char d)
+{
+    switch (d)
+    {
+    case DIR_UP:
+        return DIR_RIGHT;
+    case DIR_RIGHT:
+        return DIR_DOWN;
+    case DIR_DOWN:
+        return DIR_LEFT;
+    default:
+        return DIR_UP; // DIR_LEFT
+    }
+}
+
+static unsigned char perimeter_choose(const board_view_t *board, const player_t *me, void *state)
+{
+    perimeter_state_t *sp = state;
+    int x = me->x, y = me->y;
+
+    if (!sp->initialized)
+    {
+        sp->initialized = 1;
+        sp->dir = DIR_RIGHT;
+        sp->turn = 0;
+        sp->finished = 0;
+    }
+
+    if (sp->finished)
+        return STRATEGY_NO_MOVE;
+
+    // mantener mano izquierda en pared: girar izquierda si se puede; luego recto; luego derecha; luego 180.
+
+    //intento girar izquierda
+    unsigned char left = sp_turn_left(sp->dir);
+    if (sp_can_move_dir(board, x, y, left))
+    {
+        sp->dir = left;
+        sp->turn++;
+        return sp->dir;
+    }
+
+    // intento seguir recto
+    if (sp_can_move_dir(board, x, y, sp->dir))
+    {
+        sp->turn++;
+        return sp->dir;
+    }
+
+    // intento girar derecha
+    unsigned char right = sp_turn_right(sp->dir);
+    if (sp_can_move_dir(board, x, y, right))
+    {
+        sp->dir = right;
+        sp->turn++;
+        return sp->dir;
+    }
+
+    // intento dar vuelta
+    unsigned char back = sp_turn_right(sp_turn_right(sp->dir));
+    if (sp_can_move_dir(board, x, y, back))
+    {
+        sp->dir = back;
+        sp->turn++;
+        return sp->dir;
+    }
+
+    // ninguna libre -> terminado
+    sp->finished = 1;
+    return STRATEGY_NO_MOVE;
+}
+
+const chomp_strategy_t perimeter_strategy = {
+    .abi_version = CHOMP_STRATEGY_ABI_VERSION,
+    .name = "perimeter",
+    .state_size = sizeof(perimeter_state_t),
+    .choose = perimeter_choose,
+};
+CHOMP_EXPORT_STRATEGY(perimeter_strategy)
@@ -0,0 +1,93 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "strategy.h"
+
+// Greedy por regiones: además de la celda vecina mira cuánta recompensa queda en el
+// cuadrado que se abre en esa dirección, para no meterse en zonas ya comidas. Con el
+// índice del máster (board->index) cada región cuesta O(log W · log H); sin él se recorre
+// celda por celda, que es lo que el índice evita.
+#define REGION_MIN_RADIUS 2
+#define REGION_RADIUS_DIVISOR 8 // Radio = lado menor / 8
+#define REGION_CELL_WEIGHT 16   // Cuánto pesa la celda inmediata frente a la región
+
+static int region_radius(const board_view_t *board)
+{
+    int side = board->width < board->height ? board->width : board->height;
+    int radius = side / REGION_RADIUS_DIVISOR;
+    return radius < REGION_MIN_RADIUS ? REGION_MIN_RADIUS : radius;
+}
+
+static int64_t scan_rect(const board_view_t *board, int x0, int y0, int x1, int y1)
+{
+    if (x0 < 0)
+        x0 = 0;
+    if (y0 < 0)
+        y0 = 0;
+    if (x1 > board->width)
+        x1 = board->width;
+    if (y1 > board->height)
+        y1 = board->height;
+
+    int64_t sum = 0;
+    for (int y = y0; y < y1; y++)
+    {
+        for (int x = x0; x < x1; x++)
+        {
+            int value = board->cells[BOARD_INDEX(board->width, x, y)];
+            if (value >= MIN_REWARD && value <= MAX_REWARD)
+                sum += value;
+        }
+    }
+    return sum;
+}
+
+// Cuadrado de lado 2r+1 centrado r celdas más allá del vecino en la dirección elegida
+static int64_t region_value(const board_view_t *board, int x, int y, int dx, int dy, int radius)
+{
+    int cx = x + dx * radius;
+    int cy = y + dy * radius;
+    int x0 = cx - radius, y0 = cy - radius;
+    int x1 = cx + radius + 1, y1 = cy + radius + 1;
+    if (board->index)
+        return reward_index_rect(board->index, x0, y0, x1, y1);
+    return scan_rect(board, x0, y0, x1, y1);
+}
+
+static unsigned char region_choose(const board_view_t *board, const player_t *me, void *state)
+{
+    (void)state;
+    int radius = region_radius(board);
+    unsigned char best_move = 0;
+    int64_t best_score = -1;
+
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int dx, dy;
+        get_direction_offset(dir, &dx, &dy);
+        int new_x = me->x + dx;
+        int new_y = me->y + dy;
+        if (new_x < 0 || new_x >= board->width || new_y < 0 || new_y >= board->height)
+            continue;
+
+        int cell_value = board->cells[BOARD_INDEX(board->width, new_x, new_y)];
+        if (cell_value < MIN_REWARD || cell_value > MAX_REWARD)
+            continue;
+
+        int64_t score = (int64_t)cell_value * REGION_CELL_WEIGHT + region_value(board, new_x, new_y, dx, dy, radius);
+        if (score > best_score)
+        {
+            best_score = score;
+            best_move = dir;
+        }
+    }
+
+    return best_move;
+}
+
+const chomp_strategy_t region_strategy = {
+    .abi_version = CHOMP_STRATEGY_ABI_VERSION,
+    .name = "region",
+    .state_size = 0,
+    .choose = region_choose,
+};
+CHOMP_EXPORT_STRATEGY(region_strategy)
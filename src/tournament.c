@@ -0,0 +1,382 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "common.h"
+#include <math.h>
+#include <sched.h>
+
+// Orquestador de torneos: corre muchas partidas del máster en paralelo, cada una con su
+// propio namespace de memoria compartida y fijada a un subconjunto de CPUs, y agrega los
+// resultados (--result del máster) por estrategia.
+#define DEFAULT_TOURNAMENT_SEEDS 10
+#define DEFAULT_PLAYERS_PER_GAME 2
+#define MAX_STRATEGIES 32
+#define RESULT_LINE_SIZE 128
+#define DEFAULT_MASTER_PATH "./master"
+#define RESULT_DIR_TEMPLATE "/tmp/chomp_tournament_XXXXXX"
+
+typedef struct
+{
+    const char *master_path;
+    int jobs;
+    int seeds;
+    unsigned int first_seed;
+    int width;
+    int height;
+    int timeout;
+    int players_per_game;
+    char **strategies;
+    int strategy_count;
+} tournament_config_t;
+
+// Una partida: semilla + qué estrategia ocupa cada asiento
+typedef struct
+{
+    unsigned int seed;
+    int seats[MAX_PLAYERS];
+} match_t;
+
+typedef struct
+{
+    unsigned long games;
+    unsigned long wins;
+    double score_sum;
+    double score_sq_sum;
+} strategy_stats_t;
+
+typedef struct
+{
+    pid_t pid;
+    int match;
+} slot_t;
+
+static char result_dir[] = RESULT_DIR_TEMPLATE;
+
+void print_usage_tournament(const char *program_name)
+{
+    printf("Usage: %s [-j jobs] [-n seeds] [-S first_seed] [-k players] [-w width] [-h height] [-t timeout] "
+           "[-m master] strategy1 [strategy2 ...]\n", program_name);
+    printf("  -j jobs    : Games running at the same time (default: one per CPU)\n");
+    printf("  -n seeds   : Seeds played per seating (default: %d)\n", DEFAULT_TOURNAMENT_SEEDS);
+    printf("  -S seed    : First seed (default: 1)\n");
+    printf("  -k players : Players per game (default: %d)\n", DEFAULT_PLAYERS_PER_GAME);
+    printf("  -m master  : Path to the master binary (default: %s)\n", DEFAULT_MASTER_PATH);
+    printf("Every combination of strategies is played in every rotation of seats, for every seed.\n");
+}
+
+void parse_arguments(int argc, char *argv[], tournament_config_t *config)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    config->master_path = DEFAULT_MASTER_PATH;
+    config->jobs = cpus > 0 ? (int)cpus : 1;
+    config->seeds = DEFAULT_TOURNAMENT_SEEDS;
+    config->first_seed = 1;
+    config->width = DEFAULT_WIDTH;
+    config->height = DEFAULT_HEIGHT;
+    config->timeout = DEFAULT_TIMEOUT;
+    config->players_per_game = DEFAULT_PLAYERS_PER_GAME;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "j:n:S:k:w:h:t:m:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'j':
+            config->jobs = atoi(optarg);
+            break;
+        case 'n':
+            config->seeds = atoi(optarg);
+            break;
+        case 'S':
+            config->first_seed = (unsigned int)atoi(optarg);
+            break;
+        case 'k':
+            config->players_per_game = atoi(optarg);
+            break;
+        case 'w':
+            config->width = atoi(optarg);
+            break;
+        case 'h':
+            config->height = atoi(optarg);
+            break;
+        case 't':
+            config->timeout = atoi(optarg);
+            break;
+        case 'm':
+            config->master_path = optarg;
+            break;
+        default:
+            print_usage_tournament(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    config->strategies = &argv[optind];
+    config->strategy_count = argc - optind;
+
+    if (config->strategy_count < 1 || config->strategy_count > MAX_STRATEGIES || config->jobs < 1 ||
+        config->seeds < 1 || config->players_per_game < 1 || config->players_per_game > MAX_PLAYERS)
+    {
+        print_usage_tournament(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Arma la matriz: combinaciones (con repetición si hay menos estrategias que asientos)
+// x rotaciones de asientos x semillas
+match_t *build_schedule(const tournament_config_t *config, int *match_count)
+{
+    int k = config->players_per_game;
+    int n = config->strategy_count;
+
+    // Combinaciones con repetición, en orden no decreciente
+    int capacity = 16;
+    int count = 0;
+    match_t *matches = malloc(sizeof(match_t) * capacity);
+    if (!matches)
+        error_exit("malloc schedule");
+
+    int combo[MAX_PLAYERS] = {0};
+    for (;;)
+    {
+        for (int rotation = 0; rotation < k; rotation++)
+        {
+            for (int s = 0; s < config->seeds; s++)
+            {
+                if (count == capacity)
+                {
+                    capacity *= 2;
+                    match_t *grown = realloc(matches, sizeof(match_t) * capacity);
+                    if (!grown)
+                        error_exit("realloc schedule");
+                    matches = grown;
+                }
+                match_t *m = &matches[count++];
+                m->seed = config->first_seed + s;
+                for (int seat = 0; seat < k; seat++)
+                    m->seats[seat] = combo[(seat + rotation) % k];
+            }
+        }
+
+        // Siguiente combinación
+        int i = k - 1;
+        while (i >= 0 && combo[i] == n - 1)
+            i--;
+        if (i < 0)
+            break;
+        combo[i]++;
+        for (int j = i + 1; j < k; j++)
+            combo[j] = combo[i];
+    }
+
+    *match_count = count;
+    return matches;
+}
+
+// Cada slot usa un bloque fijo de CPUs; lo heredan el máster y sus hijos
+void pin_to_slot(int slot, int jobs)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 1)
+        return;
+
+    int per_slot = cpus / jobs;
+    if (per_slot < 1)
+        per_slot = 1;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < per_slot; i++)
+        CPU_SET((slot * per_slot + i) % cpus, &set);
+
+    if (sched_setaffinity(0, sizeof(set), &set) == -1)
+        perror("sched_setaffinity");
+}
+
+void result_path(int match, char *out, size_t size)
+{
+    snprintf(out, size, "%s/game-%d.txt", result_dir, match);
+}
+
+pid_t launch_match(const tournament_config_t *config, const match_t *m, int match, int slot)
+{
+    pid_t pid = fork();
+    if (pid == -1)
+        error_exit("fork master");
+    if (pid != 0)
+        return pid;
+
+    pin_to_slot(slot, config->jobs);
+
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull != -1)
+    {
+        dup2(devnull, STDOUT_FILENO);
+        dup2(devnull, STDERR_FILENO);
+        close(devnull);
+    }
+
+    char width_str[INT_STR_BUF], height_str[INT_STR_BUF], timeout_str[INT_STR_BUF], seed_str[INT_STR_BUF];
+    char ns[SHM_NAME_SIZE / 2], result[PATH_MAX];
+    snprintf(width_str, sizeof(width_str), "%d", config->width);
+    snprintf(height_str, sizeof(height_str), "%d", config->height);
+    snprintf(timeout_str, sizeof(timeout_str), "%d", config->timeout);
+    snprintf(seed_str, sizeof(seed_str), "%u", m->seed);
+    snprintf(ns, sizeof(ns), "tourn%d_%d", (int)getppid(), match);
+    result_path(match, result, sizeof(result));
+
+    // master -w W -h H -d 0 -t T -s S --ns NS --result FILE -p p1 ... pk
+    char *args[16 + MAX_PLAYERS];
+    int argn = 0;
+    args[argn++] = (char *)config->master_path;
+    args[argn++] = "-w";
+    args[argn++] = width_str;
+    args[argn++] = "-h";
+    args[argn++] = height_str;
+    args[argn++] = "-d";
+    args[argn++] = "0";
+    args[argn++] = "-t";
+    args[argn++] = timeout_str;
+    args[argn++] = "-s";
+    args[argn++] = seed_str;
+    args[argn++] = "--ns";
+    args[argn++] = ns;
+    args[argn++] = "--result";
+    args[argn++] = result;
+    args[argn++] = "-p";
+    for (int seat = 0; seat < config->players_per_game; seat++)
+        args[argn++] = config->strategies[m->seats[seat]];
+    args[argn] = NULL;
+
+    execv(config->master_path, args);
+    _exit(EXIT_FAILURE);
+}
+
+// Suma el resultado de una partida a las estadísticas de cada estrategia
+bool collect_result(const tournament_config_t *config, const match_t *m, int match, strategy_stats_t *stats)
+{
+    char path[PATH_MAX];
+    result_path(match, path, sizeof(path));
+
+    FILE *in = fopen(path, "r");
+    if (!in)
+        return false;
+
+    unsigned int scores[MAX_PLAYERS] = {0};
+    int winner = -1;
+    char line[RESULT_LINE_SIZE];
+    while (fgets(line, sizeof(line), in))
+    {
+        int index;
+        unsigned int score, valid, invalid;
+        if (sscanf(line, "player %d %u %u %u", &index, &score, &valid, &invalid) == 4 && index >= 0 &&
+            index < MAX_PLAYERS)
+            scores[index] = score;
+        else
+            sscanf(line, "winner %d", &winner);
+    }
+    fclose(in);
+
+    for (int seat = 0; seat < config->players_per_game; seat++)
+    {
+        strategy_stats_t *s = &stats[m->seats[seat]];
+        s->games++;
+        s->score_sum += scores[seat];
+        s->score_sq_sum += (double)scores[seat] * scores[seat];
+        if (seat == winner)
+            s->wins++;
+    }
+    return true;
+}
+
+void print_report(const tournament_config_t *config, const strategy_stats_t *stats, int played, int failed,
+                  double elapsed)
+{
+    printf("%d games (%d failed) in %.2f s, %.1f games/s\n", played, failed, elapsed,
+           elapsed > 0 ? played / elapsed : 0.0);
+    printf("%-32s %8s %8s %10s %10s\n", "strategy", "games", "win%", "avg score", "stddev");
+    for (int i = 0; i < config->strategy_count; i++)
+    {
+        const strategy_stats_t *s = &stats[i];
+        double mean = s->games ? s->score_sum / s->games : 0.0;
+        double variance = s->games ? s->score_sq_sum / s->games - mean * mean : 0.0;
+        double stddev = variance > 0 ? sqrt(variance) : 0.0;
+        printf("%-32s %8lu %7.1f%% %10.1f %10.1f\n", config->strategies[i], s->games,
+               s->games ? 100.0 * s->wins / s->games : 0.0, mean, stddev);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    tournament_config_t config;
+    parse_arguments(argc, argv, &config);
+
+    if (!mkdtemp(result_dir))
+        error_exit("mkdtemp");
+
+    int match_count;
+    match_t *matches = build_schedule(&config, &match_count);
+
+    strategy_stats_t stats[MAX_STRATEGIES];
+    memset(stats, 0, sizeof(stats));
+
+    slot_t *slots = calloc(config.jobs, sizeof(slot_t));
+    if (!slots)
+        error_exit("calloc slots");
+
+    uint64_t start = monotonic_ns();
+    int next = 0, running = 0, played = 0, failed = 0;
+
+    while (next < match_count || running > 0)
+    {
+        // Llenar todos los slots libres
+        for (int slot = 0; slot < config.jobs && next < match_count; slot++)
+        {
+            if (slots[slot].pid > 0)
+                continue;
+            slots[slot].pid = launch_match(&config, &matches[next], next, slot);
+            slots[slot].match = next;
+            next++;
+            running++;
+        }
+
+        int status;
+        pid_t done = waitpid(-1, &status, 0);
+        if (done == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            error_exit("waitpid");
+        }
+
+        for (int slot = 0; slot < config.jobs; slot++)
+        {
+            if (slots[slot].pid != done)
+                continue;
+
+            int match = slots[slot].match;
+            bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                      collect_result(&config, &matches[match], match, stats);
+            // También si el máster falló: puede haber dejado un resultado y rmdir no lo borraría
+            char path[PATH_MAX];
+            result_path(match, path, sizeof(path));
+            unlink(path);
+            if (ok)
+                played++;
+            else
+                failed++;
+
+            slots[slot].pid = 0;
+            running--;
+            break;
+        }
+    }
+
+    double elapsed = (double)(monotonic_ns() - start) / NS_PER_SECOND;
+    print_report(&config, stats, played, failed, elapsed);
+
+    rmdir(result_dir);
+    free(slots);
+    free(matches);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
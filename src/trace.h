@@ -0,0 +1,36 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "common.h"
+
+// Tracing opcional de eventos begin/end en formato Chrome trace (chrome://tracing, Perfetto).
+// Se activa con la variable de entorno CHOMP_TRACE=<directorio>: cada proceso guarda sus
+// eventos en un buffer propio y al salir escribe <directorio>/trace-<pid>.json.
+// tracemerge une los archivos de todos los procesos de la partida en un único JSON.
+// Deshabilitado, cada punto de trace cuesta un solo branch predecible.
+#define TRACE_ENV "CHOMP_TRACE"
+#define TRACE_CAPACITY (1 << 20) // Eventos por proceso; los que no entran se descartan
+#define TRACE_FILE_PREFIX "trace-"
+#define TRACE_FILE_SUFFIX ".json"
+
+extern bool trace_enabled;
+
+void trace_init(const char *process_name);
+void trace_event(const char *name, char phase);
+void trace_flush(void);
+
+#define TRACE_BEGIN(name)                        \
+    do                                           \
+    {                                            \
+        if (__builtin_expect(trace_enabled, 0)) \
+            trace_event((name), 'B');            \
+    } while (0)
+
+#define TRACE_END(name)                          \
+    do                                           \
+    {                                            \
+        if (__builtin_expect(trace_enabled, 0)) \
+            trace_event((name), 'E');            \
+    } while (0)
+
+#endif
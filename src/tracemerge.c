@@ -0,0 +1,85 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "trace.h"
+
+#define MERGE_LINE_SIZE 512
+
+// Une los trace-<pid>.json de un directorio en un único Chrome trace JSON.
+// Todos los procesos usan CLOCK_MONOTONIC, así que los timestamps ya son comparables.
+static bool is_trace_file(const char *name)
+{
+    size_t len = strlen(name);
+    size_t prefix = strlen(TRACE_FILE_PREFIX);
+    size_t suffix = strlen(TRACE_FILE_SUFFIX);
+    return len > prefix + suffix && strncmp(name, TRACE_FILE_PREFIX, prefix) == 0 &&
+           strcmp(name + len - suffix, TRACE_FILE_SUFFIX) == 0;
+}
+
+static unsigned long append_file(FILE *out, const char *path, bool *first)
+{
+    FILE *in = fopen(path, "r");
+    if (!in)
+    {
+        perror(path);
+        return 0;
+    }
+
+    unsigned long events = 0;
+    char line[MERGE_LINE_SIZE];
+    while (fgets(line, sizeof(line), in))
+    {
+        size_t len = strlen(line);
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
+            line[--len] = '\0';
+        if (len == 0)
+            continue;
+
+        fprintf(out, "%s\n%s", *first ? "" : ",", line);
+        *first = false;
+        events++;
+    }
+
+    fclose(in);
+    return events;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s <trace_dir> <output.json>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    DIR *dir = opendir(argv[1]);
+    if (!dir)
+        error_exit("opendir");
+
+    FILE *out = fopen(argv[2], "w");
+    if (!out)
+        error_exit("fopen output");
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    bool first = true;
+    unsigned long files = 0, events = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (!is_trace_file(entry->d_name))
+            continue;
+
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", argv[1], entry->d_name);
+        events += append_file(out, path, &first);
+        files++;
+    }
+    closedir(dir);
+
+    fprintf(out, "\n]}\n");
+    if (fclose(out) != 0)
+        error_exit("fclose output");
+
+    printf("Merged %lu events from %lu processes into %s\n", events, files, argv[2]);
+    return EXIT_SUCCESS;
+}
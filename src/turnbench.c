@@ -0,0 +1,199 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "turnsync.h"
+#include <sched.h>
+#include <sys/resource.h>
+
+// Latencia de ida y vuelta de un traspaso de turno: el "máster" postea player_can_move[0]
+// y espera view_done; el "jugador" (otro proceso) espera su turno y contesta. Se mide lo
+// mismo con semáforos POSIX y con futex_sem_t, sobre un game_sync_t en memoria compartida
+// anónima (no toca los segmentos de un juego en curso).
+//   -g gap_us   trabajo del máster entre turnos (lo que el jugador espera); con gaps largos
+//               la ventana de espera activa se achica sola
+//   -t think_us tiempo de decisión del jugador antes de contestar
+//   -c a,b      fija máster y jugador a esas CPUs (por defecto las elige el scheduler)
+#define DEFAULT_ROUNDS 100000
+#define WARMUP_ROUNDS 1000
+#define PERCENT_P50 50
+#define PERCENT_P99 99
+#define PERCENT_BASE 100
+#define NS_PER_US 1000ULL
+
+typedef struct
+{
+    long rounds;
+    long gap_us;
+    long think_us;
+    uint32_t spin_max;
+    int master_cpu; // -1 = sin fijar
+    int player_cpu;
+} bench_config_t;
+
+void print_usage_turnbench(const char *program_name)
+{
+    printf("Usage: %s [-n rounds] [-s spin_max] [-g gap_us] [-t think_us] [-c master_cpu,player_cpu]\n", program_name);
+    printf("  -n rounds   : Measured round trips per mode (default: %d)\n", DEFAULT_ROUNDS);
+    printf("  -s spin_max : Futex spin iterations before sleeping (default: %d)\n", TURN_SPIN_DEFAULT);
+    printf("  -g gap_us   : Master busy time between turns (default: 0)\n");
+    printf("  -t think_us : Player busy time before answering (default: 0)\n");
+    printf("  -c a,b      : Pin master and player to these CPUs\n");
+}
+
+// Espera activa: usleep metería al scheduler en la medición
+static void busy_wait_us(long us)
+{
+    if (us <= 0)
+        return;
+    uint64_t until = monotonic_ns() + (uint64_t)us * NS_PER_US;
+    while (monotonic_ns() < until)
+        ;
+}
+
+static void pin_to_cpu(int cpu)
+{
+    if (cpu < 0)
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1)
+        perror("sched_setaffinity");
+}
+
+// Mismo estado inicial que create_shared_memory: player_can_move en 1, la vista en 0
+static game_sync_t *create_bench_sync(uint32_t mode, uint32_t spin_max)
+{
+    game_sync_t *sync = mmap(NULL, sizeof(game_sync_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (sync == MAP_FAILED)
+        error_exit("mmap game_sync");
+    if (sem_init(&sync->view_done, 1, SEM_INIT_ZERO) == -1 || sem_init(PLAYER_CAN_MOVE(sync, 0), 1, SEM_INIT_ONE) == -1)
+        error_exit("sem_init");
+    turn_sync_init(sync, mode, spin_max);
+    return sync;
+}
+
+static void run_player(game_sync_t *sync, const bench_config_t *config, long total)
+{
+    pin_to_cpu(config->player_cpu);
+    for (long i = 0; i <= total; i++) // La primera vuelta consume el permiso inicial
+    {
+        turn_wait(sync, 0);
+        if (i > 0)
+            busy_wait_us(config->think_us);
+        turn_post(sync, TURN_SLOT_VIEW_DONE);
+    }
+    _exit(EXIT_SUCCESS);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t *sorted, long count, int percent)
+{
+    long index = count * percent / PERCENT_BASE;
+    if (index >= count)
+        index = count - 1;
+    return (double)sorted[index] / NS_PER_US;
+}
+
+void run_mode(const char *name, uint32_t mode, const bench_config_t *config, uint64_t *latency)
+{
+    game_sync_t *sync = create_bench_sync(mode, config->spin_max);
+    long total = WARMUP_ROUNDS + config->rounds;
+
+    pid_t pid = fork();
+    if (pid == -1)
+        error_exit("fork");
+    if (pid == 0)
+        run_player(sync, config, total);
+
+    pin_to_cpu(config->master_cpu);
+    turn_wait(sync, TURN_SLOT_VIEW_DONE); // El jugador ya está listo
+
+    struct rusage before, after, player;
+    getrusage(RUSAGE_SELF, &before);
+    for (long i = 0; i < total; i++)
+    {
+        busy_wait_us(config->gap_us);
+        uint64_t start = monotonic_ns();
+        turn_post(sync, 0);
+        turn_wait(sync, TURN_SLOT_VIEW_DONE);
+        if (i >= WARMUP_ROUNDS)
+            latency[i - WARMUP_ROUNDS] = monotonic_ns() - start;
+    }
+    getrusage(RUSAGE_SELF, &after);
+
+    int status;
+    if (wait4(pid, &status, 0, &player) == -1)
+        error_exit("wait4");
+
+    qsort(latency, config->rounds, sizeof(uint64_t), compare_u64);
+    uint64_t sum = 0;
+    for (long i = 0; i < config->rounds; i++)
+        sum += latency[i];
+    long switches = (after.ru_nvcsw - before.ru_nvcsw) + player.ru_nvcsw;
+
+    printf("%-6s %10ld %9.2f %9.2f %9.2f %9.2f %10.2f %9u\n", name, config->rounds,
+           (double)sum / config->rounds / NS_PER_US, percentile_us(latency, config->rounds, PERCENT_P50),
+           percentile_us(latency, config->rounds, PERCENT_P99), (double)latency[config->rounds - 1] / NS_PER_US,
+           (double)switches / total, mode == TURN_MODE_FUTEX ? sync->turn_futex[0].spin : 0);
+
+    munmap(sync, sizeof(game_sync_t));
+}
+
+int main(int argc, char *argv[])
+{
+    bench_config_t config = {DEFAULT_ROUNDS, 0, 0, TURN_SPIN_DEFAULT, -1, -1};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:g:t:c:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            config.rounds = atol(optarg);
+            break;
+        case 's':
+            config.spin_max = (uint32_t)atol(optarg);
+            break;
+        case 'g':
+            config.gap_us = atol(optarg);
+            break;
+        case 't':
+            config.think_us = atol(optarg);
+            break;
+        case 'c':
+            if (sscanf(optarg, "%d,%d", &config.master_cpu, &config.player_cpu) != 2)
+            {
+                print_usage_turnbench(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            print_usage_turnbench(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (config.rounds <= 0)
+    {
+        print_usage_turnbench(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t *latency = malloc(config.rounds * sizeof(uint64_t));
+    if (!latency)
+        error_exit("malloc latency");
+
+    printf("cpus=%ld gap=%ldus think=%ldus spin_max=%u\n", sysconf(_SC_NPROCESSORS_ONLN), config.gap_us,
+           config.think_us, config.spin_max);
+    printf("%-6s %10s %9s %9s %9s %9s %10s %9s\n", "mode", "rounds", "avg_us", "p50_us", "p99_us", "max_us",
+           "csw/round", "spin");
+    run_mode("sem", TURN_MODE_SEM, &config, latency);
+    run_mode("futex", TURN_MODE_FUTEX, &config, latency);
+
+    free(latency);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include "turnsync.h"
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define SPIN_ADAPT_SHIFT 3      // La estimación se mueve 1/8 hacia cada nueva observación
+#define SPIN_WORTH_NS 50000ULL // Una espera más corta que esto se hubiera cubierto girando
+
+// Sin FUTEX_PRIVATE_FLAG: la palabra vive en memoria compartida entre procesos
+static long futex(uint32_t *addr, int op, uint32_t val)
+{
+    return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+static bool try_take(futex_sem_t *fs)
+{
+    uint32_t value = __atomic_load_n(&fs->value, __ATOMIC_RELAXED);
+    while (value > 0)
+    {
+        if (__atomic_compare_exchange_n(&fs->value, &value, value - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return true;
+    }
+    return false;
+}
+
+// Cada slot tiene un solo proceso que espera, así que la estimación no tiene carreras
+static void adapt_spin(futex_sem_t *fs, uint32_t target, uint32_t spin_max)
+{
+    int64_t spin = __atomic_load_n(&fs->spin, __ATOMIC_RELAXED);
+    spin += ((int64_t)target - spin) >> SPIN_ADAPT_SHIFT;
+    if (spin < TURN_SPIN_MIN)
+        spin = TURN_SPIN_MIN;
+    if (spin > spin_max)
+        spin = spin_max;
+    __atomic_store_n(&fs->spin, (uint32_t)spin, __ATOMIC_RELAXED);
+}
+
+void futex_sem_post(futex_sem_t *fs)
+{
+    __atomic_add_fetch(&fs->value, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&fs->waiters, __ATOMIC_SEQ_CST) > 0)
+        futex(&fs->value, FUTEX_WAKE, 1);
+}
+
+void futex_sem_wait(futex_sem_t *fs, uint32_t spin_max)
+{
+    uint32_t limit = __atomic_load_n(&fs->spin, __ATOMIC_RELAXED);
+    if (limit > spin_max)
+        limit = spin_max;
+
+    // Fase activa: si el post llega a tiempo no hay cambio de contexto. Si ya estaba
+    // posteado no se aprende nada; si llegó girando, el objetivo es el doble de lo girado.
+    for (uint32_t i = 0; i <= limit; i++)
+    {
+        if (try_take(fs))
+        {
+            if (i > 0 && spin_max > 0)
+                adapt_spin(fs, 2 * i, spin_max);
+            return;
+        }
+        cpu_relax();
+    }
+
+    // waiters se publica antes de volver a mirar value (el post hace lo inverso), así
+    // ningún post queda sin wake
+    uint64_t sleep_start = monotonic_ns();
+    __atomic_add_fetch(&fs->waiters, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while (!try_take(fs))
+        futex(&fs->value, FUTEX_WAIT, 0); // EAGAIN si value ya cambió, EINTR con señales
+    __atomic_sub_fetch(&fs->waiters, 1, __ATOMIC_SEQ_CST);
+
+    // Si el post llegó poco después de rendirnos, girar más lo hubiera evitado; si tardó
+    // mucho, girar fue tiempo de CPU perdido y la ventana se achica
+    if (spin_max > 0)
+    {
+        bool short_sleep = monotonic_ns() - sleep_start < SPIN_WORTH_NS;
+        adapt_spin(fs, short_sleep ? spin_max : limit / 2, spin_max);
+    }
+}
+
+void turn_sync_init(game_sync_t *sync, uint32_t mode, uint32_t spin_max)
+{
+    if (sysconf(_SC_NPROCESSORS_ONLN) < 2)
+        spin_max = 0;
+
+    for (int slot = 0; slot < TURN_SLOTS; slot++)
+    {
+        sync->turn_futex[slot].value = slot < MAX_PLAYERS ? 1 : 0;
+        sync->turn_futex[slot].waiters = 0;
+        sync->turn_futex[slot].spin = spin_max;
+    }
+    sync->turn_spin_max = spin_max;
+    __atomic_store_n(&sync->turn_mode, mode, __ATOMIC_RELEASE);
+}
+
+static sem_t *turn_sem(game_sync_t *sync, int slot)
+{
+    if (slot == TURN_SLOT_VIEW_NOTIFY)
+        return &sync->view_notify;
+    if (slot == TURN_SLOT_VIEW_DONE)
+        return &sync->view_done;
+    return PLAYER_CAN_MOVE(sync, slot);
+}
+
+void turn_post(game_sync_t *sync, int slot)
+{
+    if (sync->turn_mode == TURN_MODE_FUTEX)
+        futex_sem_post(&sync->turn_futex[slot]);
+    else
+        sem_post(turn_sem(sync, slot));
+}
+
+void turn_wait(game_sync_t *sync, int slot)
+{
+    if (sync->turn_mode == TURN_MODE_FUTEX)
+        futex_sem_wait(&sync->turn_futex[slot], sync->turn_spin_max);
+    else
+        sem_wait(turn_sem(sync, slot));
+}
@@ -0,0 +1,24 @@
+#ifndef TURNSYNC_H
+#define TURNSYNC_H
+
+#include "common.h"
+
+// Traspasos de turno entre máster, jugadores y vista. Con TURN_MODE_SEM son los semáforos
+// POSIX de siempre; con TURN_MODE_FUTEX, futex_sem_t: el que espera gira un rato (acotado
+// por turn_spin_max y adaptado a cuánto tardaron las esperas anteriores) antes de dormir
+// en FUTEX_WAIT, y el post solo entra al kernel si hay alguien dormido.
+// Slots: 0..MAX_PLAYERS-1 son player_can_move, además de TURN_SLOT_VIEW_NOTIFY/DONE.
+#define TURN_SPIN_DEFAULT 2000 // Vueltas (con pause) antes de dormir: unas decenas de µs
+#define TURN_SPIN_MIN 16       // Piso de la adaptación, para poder volver a crecer
+
+// Elige el mecanismo e inicializa los futex (player_can_move en 1, la vista en 0 como los
+// semáforos). spin_max se fuerza a 0 con una sola CPU: girar solo le robaría el núcleo al
+// proceso que tiene que despertarnos.
+void turn_sync_init(game_sync_t *sync, uint32_t mode, uint32_t spin_max);
+void turn_post(game_sync_t *sync, int slot);
+void turn_wait(game_sync_t *sync, int slot);
+
+void futex_sem_post(futex_sem_t *fs);
+void futex_sem_wait(futex_sem_t *fs, uint32_t spin_max);
+
+#endif
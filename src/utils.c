@@ -1,6 +1,8 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include "common.h"
+#include "probes.h"
+#include "frame_stream.h"
 
 void error_exit(const char *msg)
 {
@@ -8,20 +10,47 @@ void error_exit(const char *msg)
     exit(EXIT_FAILURE);
 }
 
+// write() que reintenta hasta escribir todo (o fallar)
+int write_all(int fd, const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    while (size > 0)
+    {
+        ssize_t written = write(fd, p, size);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += written;
+        size -= written;
+    }
+    return 0;
+}
+
+// Reloj monotónico en nanosegundos para medir intervalos
+uint64_t monotonic_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SECOND + ts.tv_nsec;
+}
+
 int get_board_cell(game_state_t *state, int x, int y)
 {
     if (x < 0 || x >= state->width || y < 0 || y >= state->height)
     {
     return OUT_OF_BOUNDS_CELL_VALUE; // Valor inválido para indicar fuera de límites
     }
-    return state->board[y * state->width + x];
+    return state->board[BOARD_INDEX(state->width, x, y)];
 }
 
 void set_board_cell(game_state_t *state, int x, int y, int value)
 {
     if (x >= 0 && x < state->width && y >= 0 && y < state->height)
     {
-        state->board[y * state->width + x] = value;
+        state->board[BOARD_INDEX(state->width, x, y)] = value;
     }
 }
 
@@ -83,21 +112,84 @@ void get_direction_offset(unsigned char direction, int *dx, int *dy)
     }
 }
 
+// Arma una copia de player_t independiente del layout del estado compartido
+void get_player(game_state_t *state, unsigned int player_id, player_t *out)
+{
+    memcpy(out->name, PLAYER_NAME(state, player_id), PLAYER_NAME_SIZE);
+    out->score = PLAYER_SCORE(state, player_id);
+    out->invalid_moves = PLAYER_INVALID_MOVES(state, player_id);
+    out->valid_moves = PLAYER_VALID_MOVES(state, player_id);
+    out->x = PLAYER_X(state, player_id);
+    out->y = PLAYER_Y(state, player_id);
+    out->pid = PLAYER_PID(state, player_id);
+    out->blocked = PLAYER_BLOCKED(state, player_id);
+}
+
+// Id pasado por el máster en PLAYER_ID_ENV; -1 si no está (p. ej. lo lanzó el máster de referencia)
+int player_id_from_env(const game_state_t *state)
+{
+    const char *value = getenv(PLAYER_ID_ENV);
+    if (!value || !*value)
+        return -1;
+
+    char *end;
+    long id = strtol(value, &end, 10);
+    if (*end != '\0' || id < 0 || id >= (long)state->player_count)
+        return -1;
+    return (int)id;
+}
+
 void print_usage_master(const char *program_name)
 {
-    printf("Usage: %s [-w width] [-h height] [-d delay] [-t timeout] [-s seed] [-v view] -p player1 [player2 ...]\n", program_name);
+    printf("Usage: %s [-w width] [-h height] [-d delay] [-t timeout] [-s seed] [-v view] [-r replay] [--rng name] [--profile name] [--gen-threads n] [--map file] [--save-map file] [--ns name] [--result file] [--memfd] [--inproc] [--futex] [--sched policy] [--hugepages] [--prefault] [--mlock] -p player1 [player2 ...]\n", program_name);
     printf("  -w width   : Board width (default: %d, minimum: %d)\n", DEFAULT_WIDTH, MIN_BOARD_SIZE);
     printf("  -h height  : Board height (default: %d, minimum: %d)\n", DEFAULT_HEIGHT, MIN_BOARD_SIZE);
     printf("  -d delay   : Delay in milliseconds between state updates (default: %d)\n", DEFAULT_DELAY);
     printf("  -t timeout : Timeout in seconds for valid moves (default: %d)\n", DEFAULT_TIMEOUT);
     printf("  -s seed    : Random seed (default: current time)\n");
     printf("  -v view    : Path to view binary (optional)\n");
+    printf("  -r replay  : Record a binary replay of the game to this file (optional)\n");
+    printf("  --rng name : Board RNG: philox (portable, default) or libc (srand/rand)\n");
+    printf("  --profile name : Reward distribution: uniform (default), clustered or gradient\n");
+    printf("  --gen-threads n : Threads used to fill the board (default: one per CPU)\n");
+    printf("  --map file : Load the board (and players, if it is a checkpoint) from a map file\n");
+    printf("  --save-map file : Save a checkpoint at the end of the game and on SIGUSR1\n");
+    printf("  --ns name  : Shared-memory namespace, lets several games run on one host\n");
+    printf("  --result file : Write the final scores and the winner to this file\n");
+    printf("  --memfd    : Use anonymous memfd segments passed to children by descriptor\n");
+    printf("  --inproc   : Players are strategies (built-in name or plugin .so) called from the master, no player processes\n");
+    printf("  --futex    : Hand off turns with spin-then-sleep futexes instead of POSIX semaphores\n");
+    printf("  --hugepages : Ask for transparent huge pages on the state segment (needs shmem THP)\n");
+    printf("  --prefault : Fault the whole state segment in when it is mapped (master, view and players)\n");
+    printf("  --mlock    : Lock the state segment in memory (subject to ulimit -l)\n");
+    printf("  --sched policy : Order in which ready players are served: rr (default), fifo or wfq[:w0,w1,...]\n");
     printf("  -p players : Paths to player binaries (minimum: 1, maximum: %d)\n", MAX_PLAYERS);
 }
 
 void print_usage_view(const char *program_name)
 {
     printf("Usage: %s <width> <height>\n", program_name);
+    printf("  %s=ansi|ndjson|binary : Output format (default: ansi)\n", VIEW_OUTPUT_ENV);
+    printf("  %s=path              : Write frames to a file or FIFO (default: stdout)\n", VIEW_FILE_ENV);
+    printf("  %s=N                : Write every Nth frame; the final one always\n", VIEW_EVERY_ENV);
+}
+
+void print_usage_replay(const char *program_name)
+{
+    printf("Usage: %s [-v view] [-d delay] [-m map] [-q] replay_file\n", program_name);
+    printf("  -v view    : Path to view binary, shows every replayed move (optional)\n");
+    printf("  -d delay   : Delay in milliseconds between moves when using a view (default: 0)\n");
+    printf("  -m map     : Start from this map file instead of the recorded seed\n");
+    printf("  -q         : Do not print the final standings\n");
+}
+
+void print_usage_chompstat(const char *program_name)
+{
+    printf("Usage: %s [-N namespace | -p master_pid] [-i interval_ms] [-n samples]\n", program_name);
+    printf("  -N namespace   : Shared-memory namespace of the game to watch (default: $%s)\n", SHM_NAMESPACE_ENV);
+    printf("  -p master_pid  : Watch a master started with --memfd\n");
+    printf("  -i interval_ms : Sampling interval (default: %d)\n", DEFAULT_STATS_INTERVAL);
+    printf("  -n samples     : Stop after this many samples (default: until the game ends)\n");
 }
 
 void print_usage_player(const char *program_name)
@@ -110,7 +202,7 @@ void cleanup_shared_memory(game_state_t *game_state, game_sync_t *game_sync)
 {
     if (game_state)
     {
-        size_t state_size = sizeof(game_state_t) + sizeof(int) * game_state->width * game_state->height;
+        size_t state_size = sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(game_state->width, game_state->height);
         munmap(game_state, state_size);
     }
     
@@ -120,12 +212,287 @@ void cleanup_shared_memory(game_state_t *game_state, game_sync_t *game_sync)
     }
 }
 
+// Lado lector del lock lectores-escritor sobre el estado: el primer lector toma state_mutex
+// (el máster escribe con state_mutex tomado) y el último lo suelta
+void read_lock_state(game_sync_t *game_sync)
+{
+    sem_wait(&game_sync->reader_count_mutex);
+    game_sync->reader_count++;
+    if (game_sync->reader_count == 1)
+        sem_wait(&game_sync->state_mutex);
+    sem_post(&game_sync->reader_count_mutex);
+}
+
+void read_unlock_state(game_sync_t *game_sync)
+{
+    sem_wait(&game_sync->reader_count_mutex);
+    game_sync->reader_count--;
+    if (game_sync->reader_count == 0)
+        sem_post(&game_sync->state_mutex);
+    sem_post(&game_sync->reader_count_mutex);
+}
+
+// Un namespace válido no puede tener '/' (los nombres POSIX de shm tienen una sola barra)
+bool valid_shm_namespace(const char *ns)
+{
+    size_t len = strlen(ns);
+    if (len == 0 || len > SHM_NAME_SIZE / 2)
+        return false;
+    return strchr(ns, '/') == NULL;
+}
+
+// Nombre real del objeto de memoria compartida según el namespace del juego
+int shm_object_name(const char *base, char *out, size_t size)
+{
+    const char *ns = getenv(SHM_NAMESPACE_ENV);
+    int len;
+    if (ns && *ns)
+        len = snprintf(out, size, "/%s.%s", ns, base + 1);
+    else
+        len = snprintf(out, size, "%s", base);
+
+    if (len < 0 || (size_t)len >= size)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return 0;
+}
+
+int shm_open_ns(const char *base, int flags, mode_t mode)
+{
+    char name[SHM_NAME_SIZE];
+    if (shm_object_name(base, name, sizeof(name)) == -1)
+        return -1;
+    return shm_open(name, flags, mode);
+}
+
+int shm_unlink_ns(const char *base)
+{
+    char name[SHM_NAME_SIZE];
+    if (shm_object_name(base, name, sizeof(name)) == -1)
+        return -1;
+    return shm_unlink(name);
+}
+
+// Crea un segmento del tamaño pedido: objeto POSIX con nombre o memfd anónimo sellado
+int create_segment(const char *base, const char *memfd_name, size_t size, int flags)
+{
+    int fd;
+    if (flags & SHM_FLAG_MEMFD)
+        fd = memfd_create(memfd_name, MFD_ALLOW_SEALING);
+    else
+        fd = shm_open_ns(base, O_CREAT | O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1)
+        return -1;
+
+    if (ftruncate(fd, size) == -1)
+    {
+        close(fd);
+        return -1;
+    }
+
+    // Con el tamaño sellado ningún hijo puede achicar el segmento (SIGBUS en los demás).
+    // F_SEAL_SEAL lo agrega seal_segment() una vez que el máster mapeó el segmento
+    if ((flags & SHM_FLAG_MEMFD) && fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) == -1)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Linux >= 5.1; con headers más viejos el kernel igual lo entiende o devuelve EINVAL
+#ifndef F_SEAL_FUTURE_WRITE
+#define F_SEAL_FUTURE_WRITE 0x0010
+#endif
+
+// Cierra los sellos de un memfd que el máster ya mapeó. Los hijos heredan el descriptor
+// O_RDWR: con read_only (F_SEAL_FUTURE_WRITE) no pueden mapearlo con PROT_WRITE ni usar
+// write(), igual que con shm_open(O_RDONLY) en modo con nombre; el mapeo del máster sigue
+// siendo escribible. Llamar después del mmap del máster.
+int seal_segment(int fd, bool read_only)
+{
+    if (read_only && fcntl(fd, F_ADD_SEALS, F_SEAL_FUTURE_WRITE) == -1)
+        return -1;
+    return fcntl(fd, F_ADD_SEALS, F_SEAL_SEAL);
+}
+
+// Kernels anteriores a 5.14 no los definen; ahí madvise falla con EINVAL y se toca cada página
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+// Aplica SHM_FLAG_HUGEPAGES/PREFAULT/MLOCK a un mapeo del estado. Nada de esto es necesario
+// para jugar: si el kernel o los límites no lo permiten se avisa y se sigue. Devuelve -1 si
+// algo no se pudo aplicar.
+int tune_state_mapping(void *addr, size_t size, int flags, bool writable)
+{
+    int status = 0;
+    // Antes de cargar las páginas: las que ya están cargadas quedan en páginas de 4 KiB
+    if ((flags & SHM_FLAG_HUGEPAGES) && madvise(addr, size, MADV_HUGEPAGE) == -1)
+    {
+        perror("madvise MADV_HUGEPAGE");
+        status = -1;
+    }
+    if ((flags & SHM_FLAG_PREFAULT) && madvise(addr, size, writable ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) == -1)
+    {
+        long page = sysconf(_SC_PAGESIZE);
+        volatile const unsigned char *bytes = addr;
+        for (size_t offset = 0; offset < size; offset += page)
+            (void)bytes[offset];
+    }
+    if ((flags & SHM_FLAG_MLOCK) && mlock(addr, size) == -1)
+    {
+        perror("mlock state (see ulimit -l)");
+        status = -1;
+    }
+    return status;
+}
+
+// Exporta el descriptor en el entorno para que lo encuentren la vista y los jugadores tras exec
+int export_segment_fd(const char *env_name, int fd)
+{
+    char value[INT_STR_BUF];
+    snprintf(value, sizeof(value), "%d", fd);
+    return setenv(env_name, value, 1);
+}
+
+// Crea, dimensiona y mapea las memorias compartidas e inicializa los semáforos
+int create_shared_memory(int width, int height, unsigned int player_count, int flags, game_state_t **game_state, game_sync_t **game_sync)
+{
+    size_t state_size = sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(width, height);
+    //Calcula el tamaño real a mapear para game_state: estructura base + arreglo flexible board (width*height ints).
+
+    int state_shm_fd = create_segment(GAME_STATE_SHM, "game_state", state_size, flags);
+    if (state_shm_fd == -1)
+        return -1;
+
+    *game_state = mmap(NULL, state_size, PROT_READ | PROT_WRITE, MAP_SHARED, state_shm_fd, 0);
+    if (*game_state == MAP_FAILED)
+    {
+        *game_state = NULL;
+        close(state_shm_fd);
+        return -1;
+    }
+    if (flags & SHM_MAPPING_FLAGS)
+    {
+        tune_state_mapping(*game_state, state_size, flags, true);
+        char value[INT_STR_BUF];
+        snprintf(value, sizeof(value), "%d", flags & SHM_MAPPING_FLAGS);
+        setenv(SHM_FLAGS_ENV, value, 1);
+    }
+    else
+        unsetenv(SHM_FLAGS_ENV);
+
+    // Crear memoria compartida para sincronización
+    int sync_shm_fd = create_segment(GAME_SYNC_SHM, "game_sync", sizeof(game_sync_t), flags);
+    if (sync_shm_fd == -1)
+    {
+        close(state_shm_fd);
+        munmap(*game_state, state_size);
+        *game_state = NULL;
+        return -1;
+    }
+
+    *game_sync = mmap(NULL, sizeof(game_sync_t), PROT_READ | PROT_WRITE, MAP_SHARED, sync_shm_fd, 0);
+    if (*game_sync == MAP_FAILED)
+    {
+        *game_sync = NULL;
+        close(state_shm_fd);
+        close(sync_shm_fd);
+        munmap(*game_state, state_size);
+        *game_state = NULL;
+        return -1;
+    }
+
+    if (flags & SHM_FLAG_MEMFD)
+    {
+        // Los descriptores quedan abiertos (sin CLOEXEC) hasta lanzar los hijos;
+        // después se cierran con close_inherited_segments(). El estado solo lo escribe el máster
+        if (seal_segment(state_shm_fd, true) == -1 || seal_segment(sync_shm_fd, false) == -1 ||
+            export_segment_fd(SHM_STATE_FD_ENV, state_shm_fd) == -1 ||
+            export_segment_fd(SHM_SYNC_FD_ENV, sync_shm_fd) == -1)
+            return -1;
+    }
+    else
+    {
+        close(state_shm_fd);
+        close(sync_shm_fd);
+    }
+
+    // Inicializar estado del juego
+    (*game_state)->width = width;
+    (*game_state)->height = height;
+    (*game_state)->player_count = player_count;
+    (*game_state)->game_finished = false;
+
+    // Inicializar semáforos
+    game_sync_t *sync = *game_sync;
+    if (sem_init(&sync->view_notify, 1, SEM_INIT_ZERO) == -1 ||
+        sem_init(&sync->view_done, 1, SEM_INIT_ZERO) == -1 ||
+        sem_init(&sync->master_access, 1, SEM_INIT_ONE) == -1 ||
+        sem_init(&sync->state_mutex, 1, SEM_INIT_ONE) == -1 ||
+        sem_init(&sync->reader_count_mutex, 1, SEM_INIT_ONE) == -1)
+        return -1;
+    sync->reader_count = 0;
+
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        if (sem_init(PLAYER_CAN_MOVE(sync, i), 1, SEM_INIT_ONE) == -1)
+            return -1;
+    }
+
+    return 0;
+}
+
+// Devuelve el descriptor heredado por entorno, o -1 si el segmento es con nombre
+static int inherited_segment_fd(const char *env_name)
+{
+    const char *value = getenv(env_name);
+    if (!value || !*value)
+        return -1;
+    return atoi(value);
+}
+
+// Cierra los memfd que el máster mantuvo abiertos para los hijos
+void close_inherited_segments(void)
+{
+    const char *envs[] = {SHM_STATE_FD_ENV, SHM_SYNC_FD_ENV, SHM_INDEX_FD_ENV};
+    for (size_t i = 0; i < sizeof(envs) / sizeof(envs[0]); i++)
+    {
+        int fd = inherited_segment_fd(envs[i]);
+        if (fd != -1)
+            close(fd);
+        unsetenv(envs[i]);
+    }
+}
+
+// Elimina las entradas de /dev/shm; el kernel libera la memoria cuando nadie la tenga mapeada
+void unlink_shared_memory(void)
+{
+    shm_unlink_ns(GAME_STATE_SHM);
+    shm_unlink_ns(GAME_SYNC_SHM);
+}
+
+// Abre un segmento existente: el memfd heredado del máster o el objeto con nombre
+int open_segment(const char *base, const char *fd_env, int oflag)
+{
+    int fd = inherited_segment_fd(fd_env);
+    if (fd != -1)
+        return fd;
+    return shm_open_ns(base, oflag, 0);
+}
+
 int connect_shared_memory(int width, int height, game_state_t **game_state, game_sync_t **game_sync)
 {
-    size_t state_size = sizeof(game_state_t) + sizeof(int) * width * height;
+    size_t state_size = sizeof(game_state_t) + sizeof(int) * BOARD_CELLS(width, height);
 
     // Conectar a memoria compartida del estado
-    int state_shm_fd = shm_open(GAME_STATE_SHM, O_RDONLY, 0);
+    int state_shm_fd = open_segment(GAME_STATE_SHM, SHM_STATE_FD_ENV, O_RDONLY);
     if (state_shm_fd == -1)
         return -1;
 
@@ -136,9 +503,12 @@ int connect_shared_memory(int width, int height, game_state_t **game_state, game
         return -1;
     }
     close(state_shm_fd);
+    const char *mapping_flags = getenv(SHM_FLAGS_ENV);
+    if (mapping_flags && *mapping_flags)
+        tune_state_mapping(*game_state, state_size, atoi(mapping_flags) & SHM_MAPPING_FLAGS, false);
 
     // Conectar a memoria compartida de sincronización
-    int sync_shm_fd = shm_open(GAME_SYNC_SHM, O_RDWR, 0);
+    int sync_shm_fd = open_segment(GAME_SYNC_SHM, SHM_SYNC_FD_ENV, O_RDWR);
     if (sync_shm_fd == -1)
     {
         munmap(*game_state, state_size);
@@ -174,23 +544,184 @@ int find_winner(game_state_t *state)
 
     for (unsigned int i = 0; i < state->player_count; i++)
     {
-        player_t *p = &state->players[i];
+        unsigned int score = PLAYER_SCORE(state, i);
+        unsigned int valid_moves = PLAYER_VALID_MOVES(state, i);
+        unsigned int invalid_moves = PLAYER_INVALID_MOVES(state, i);
 
         // Criterios de ganador (en orden de prioridad):
         // 1. Mayor puntaje
         // 2. Si empate en puntaje, menos movimientos válidos (más eficiente)
         // 3. Si empate completo, menos movimientos inválidos
-        if (p->score > max_score ||
-            (p->score == max_score && p->valid_moves < min_valid_moves) ||
-            (p->score == max_score && p->valid_moves == min_valid_moves && p->invalid_moves < min_invalid_moves))
+        if (score > max_score ||
+            (score == max_score && valid_moves < min_valid_moves) ||
+            (score == max_score && valid_moves == min_valid_moves && invalid_moves < min_invalid_moves))
         {
 
             winner = i;
-            max_score = p->score;
-            min_valid_moves = p->valid_moves;
-            min_invalid_moves = p->invalid_moves;
+            max_score = score;
+            min_valid_moves = valid_moves;
+            min_invalid_moves = invalid_moves;
         }
     }
 
     return winner;
 }
+
+// Coloca jugadores en posiciones iniciales y pone datos iniciales en cada jugador
+void place_players(game_state_t *state)
+{
+    int width = state->width;
+    int height = state->height;
+
+    // Distribución simple: colocar jugadores en esquinas y bordes
+    int positions[][2] =
+    {
+        {0, 0}, {width - 1, 0}, {0, height - 1}, {width - 1, height - 1}, {width / 2, 0}, {width / 2, height - 1}, {0, height / 2}, {width - 1, height / 2}, {width / 2, height / 2}
+    };
+
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        snprintf(PLAYER_NAME(state, i), PLAYER_NAME_SIZE, "Player%u", i);
+        PLAYER_SCORE(state, i) = 0;
+        PLAYER_INVALID_MOVES(state, i) = 0;
+        PLAYER_VALID_MOVES(state, i) = 0;
+        PLAYER_X(state, i) = positions[i][0];
+        PLAYER_Y(state, i) = positions[i][1];
+        PLAYER_BLOCKED(state, i) = false;
+
+        // Marcar celda como ocupada
+        set_board_cell(state, positions[i][0], positions[i][1], -(int)i);
+    }
+}
+
+bool process_move(game_state_t *state, int player_id, unsigned char direction)
+{
+    if (player_id < 0 || (unsigned int)player_id >= state->player_count)
+        return false;
+
+    if (PLAYER_BLOCKED(state, player_id))
+        return false;
+
+    int dx, dy;
+    get_direction_offset(direction, &dx, &dy);
+
+    int new_x = PLAYER_X(state, player_id) + dx;
+    int new_y = PLAYER_Y(state, player_id) + dy;
+
+    // Validar movimiento
+    if (!is_cell_free(state, new_x, new_y))
+    {
+        PLAYER_INVALID_MOVES(state, player_id)++;
+        CHOMP_PROBE4(move_applied, player_id, direction, 0, 0);
+
+        // Después de un movimiento inválido, verificar si el jugador debe ser bloqueado
+        if (!player_has_valid_moves(state, player_id))
+        {
+            PLAYER_BLOCKED(state, player_id) = true;
+            CHOMP_PROBE1(player_blocked, player_id);
+        }
+
+        return false;
+    }
+
+    // Movimiento válido
+    int reward = get_board_cell(state, new_x, new_y);
+    PLAYER_SCORE(state, player_id) += reward;
+    PLAYER_VALID_MOVES(state, player_id)++;
+
+    // Actualizar posición
+    PLAYER_X(state, player_id) = new_x;
+    PLAYER_Y(state, player_id) = new_y;
+    set_board_cell(state, new_x, new_y, -player_id);
+    CHOMP_PROBE4(move_applied, player_id, direction, 1, reward);
+
+    // Después de un movimiento válido, verificar si el jugador debe ser bloqueado
+    if (!player_has_valid_moves(state, player_id))
+    {
+        PLAYER_BLOCKED(state, player_id) = true;
+        CHOMP_PROBE1(player_blocked, player_id);
+    }
+
+    return true;
+}
+
+void board_to_rowmajor(const game_state_t *state, int *out)
+{
+    int width = state->width;
+    int height = state->height;
+    if (BOARD_ROWMAJOR)
+    {
+        memcpy(out, state->board, sizeof(int) * width * height);
+        return;
+    }
+    // Cada fila de una tesela son BOARD_TILE enteros contiguos en ambos formatos: se copian
+    // de a una (memcpy de tamaño fijo, queda en uno o dos movimientos vectoriales)
+    for (int y = 0; y < height; y++)
+    {
+        int x = 0;
+        for (; x + BOARD_TILE <= width; x += BOARD_TILE)
+            memcpy(&out[y * width + x], &state->board[BOARD_INDEX(width, x, y)], sizeof(int) * BOARD_TILE);
+        if (x < width)
+            memcpy(&out[y * width + x], &state->board[BOARD_INDEX(width, x, y)], sizeof(int) * (width - x));
+    }
+}
+
+void board_from_rowmajor(game_state_t *state, const int *in)
+{
+    int width = state->width;
+    int height = state->height;
+    if (BOARD_ROWMAJOR)
+    {
+        memcpy(state->board, in, sizeof(int) * width * height);
+        return;
+    }
+    for (int y = 0; y < height; y++)
+    {
+        int x = 0;
+        for (; x + BOARD_TILE <= width; x += BOARD_TILE)
+            memcpy(&state->board[BOARD_INDEX(width, x, y)], &in[y * width + x], sizeof(int) * BOARD_TILE);
+        if (x < width)
+            memcpy(&state->board[BOARD_INDEX(width, x, y)], &in[y * width + x], sizeof(int) * (width - x));
+    }
+}
+
+bool player_has_valid_moves(game_state_t *state, unsigned int player_id)
+{
+    if (player_id >= state->player_count)
+        return false;
+
+    int x = PLAYER_X(state, player_id);
+    int y = PLAYER_Y(state, player_id);
+
+    // Verificar las 8 direcciones
+    for (unsigned char dir = 0; dir < DIRECTIONS_COUNT; dir++)
+    {
+        int dx, dy;
+        get_direction_offset(dir, &dx, &dy);
+
+        int new_x = x + dx;
+        int new_y = y + dy;
+
+        if (is_cell_free(state, new_x, new_y))
+        {
+            return true; // Encontró al menos un movimiento válido
+        }
+    }
+
+    return false; // No tiene movimientos válidos
+}
+
+bool check_game_end(game_state_t *state)
+{
+    // Verificar si algún jugador puede moverse
+    for (unsigned int i = 0; i < state->player_count; i++)
+    {
+        if (PLAYER_BLOCKED(state, i))
+            continue;
+
+        if (player_has_valid_moves(state, i))
+            return false; // Al menos un jugador puede moverse
+    }
+
+    return true; // Ningún jugador puede moverse
+}
@@ -2,6 +2,10 @@
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 
 #include "common.h"
+#include "turnsync.h"
+#include "trace.h"
+#include "board_scan.h"
+#include "frame_stream.h"
 
 // Códigos ANSI para colores (sin ncurses)
 #define ANSI_RESET "\033[0m"
@@ -20,6 +24,9 @@
 
 static game_state_t *game_state = NULL;
 static game_sync_t *game_sync = NULL;
+static int *frame_cells = NULL; // Tablero del frame en orden de filas, sea cual sea el layout
+static frame_stream_t frame_stream; // Salida ndjson/binary (frame_stream.h)
+static bool streaming = false;
 
 // Función para obtener el código de color ANSI de un jugador
 const char *get_player_color(int player_num)
@@ -65,6 +72,11 @@ const char *get_player_body_symbol(int player_num)
 void cleanup_view(void)
 {
     cleanup_shared_memory(game_state, game_sync);
+    free(frame_cells);
+    frame_cells = NULL;
+    if (streaming)
+        frame_stream_close(&frame_stream);
+    streaming = false;
 }
 
 void signal_handler(int sig)
@@ -80,29 +92,40 @@ void connect_shared_memory_view(int width, int height)
     {
         error_exit("connect_shared_memory");
     }
+    frame_cells = malloc(sizeof(int) * width * height);
+    if (!frame_cells)
+        error_exit("malloc frame_cells");
 }
 
 void print_board(void)
 {
+    // El tablero se pasa a orden de filas una vez por frame (con BOARD=tiled recorrer la
+    // fila en el segmento saltaría de tesela en tesela) y se resume en una pasada vectorial
+    board_to_rowmajor(game_state, frame_cells);
+    board_summary_t summary = {0};
+    board_scan(frame_cells, (size_t)game_state->width * game_state->height, game_state->player_count, &summary);
+
     printf("\n=== ChompChamps Game State ===\n");
     printf("Board Size: %dx%d\n", game_state->width, game_state->height);
     printf("Players: %u\n", game_state->player_count);
-    printf("Game Finished: %s\n\n", game_state->game_finished ? "Yes" : "No");
+    printf("Game Finished: %s\n", game_state->game_finished ? "Yes" : "No");
+    printf("Free cells: %lu  Reward left: %lu\n\n", (unsigned long)summary.free_cells, (unsigned long)summary.reward);
 
     // Imprimir información de jugadores con colores y estilo
     printf("=== PLAYERS STATUS ===\n");
     for (unsigned int i = 0; i < game_state->player_count; i++)
     {
-        player_t *p = &game_state->players[i];
+        player_t p;
+        get_player(game_state, i, &p);
 
         // Usar color del jugador para el indicador con negrita
         printf("%s%s[P%u]%s ", get_player_color(i), ANSI_BOLD, i, ANSI_RESET);
 
         // Nombre y posición
-        printf("%s: Pos(%d,%d) Score=%u ", p->name, p->x, p->y, p->score);
+        printf("%s: Pos(%d,%d) Score=%u ", p.name, p.x, p.y, p.score);
 
         // Barra visual del score (cada asterisco = ~SCORE_BAR_UNIT_STATE puntos)
-        int score_bars = p->score / SCORE_BAR_UNIT_STATE;
+        int score_bars = p.score / SCORE_BAR_UNIT_STATE;
         if (score_bars > SCORE_BAR_MAX_STATE)
             score_bars = SCORE_BAR_MAX_STATE; // Máximo SCORE_BAR_MAX_STATE asteriscos
 
@@ -114,9 +137,9 @@ void print_board(void)
         printf("%s", ANSI_RESET);
 
         // Stats y estado
-        printf(" (Valid:%u Invalid:%u)", p->valid_moves, p->invalid_moves);
+        printf(" (Valid:%u Invalid:%u Cells:%lu)", p.valid_moves, p.invalid_moves, (unsigned long)summary.owned[i]);
 
-        if (p->blocked)
+        if (p.blocked)
         {
             printf(" [BLOCKED]");
         }
@@ -141,14 +164,14 @@ void print_board(void)
         printf("%2d ", y);
         for (int x = 0; x < game_state->width; x++)
         {
-            int cell = get_board_cell(game_state, x, y);
+            int cell = frame_cells[y * game_state->width + x];
 
             // Verificar si esta posición es la cabeza de algún jugador
             bool is_head = false;
             int head_player = -1;
             for (unsigned int i = 0; i < game_state->player_count; i++)
             {
-                if (game_state->players[i].x == x && game_state->players[i].y == y)
+                if (PLAYER_X(game_state, i) == x && PLAYER_Y(game_state, i) == y)
                 {
                     is_head = true;
                     head_player = i; // Ahora usamos indexación 0-based
@@ -191,8 +214,8 @@ void print_board(void)
         if (winner >= 0)
         {
             printf("Winner: %s with score %u\n",
-                   game_state->players[winner].name,
-                   game_state->players[winner].score);
+                   PLAYER_NAME(game_state, winner),
+                   PLAYER_SCORE(game_state, winner));
         }
         else
         {
@@ -224,11 +247,11 @@ void show_final_winner(void)
     {
         // Mostrar ganador con mucho estilo
         printf("%s%s", get_player_color(winner), ANSI_BOLD);
-        printf("    *** WINNER: %s ***\n", game_state->players[winner].name);
-        printf("    Score: %u points\n", game_state->players[winner].score);
+        printf("    *** WINNER: %s ***\n", PLAYER_NAME(game_state, winner));
+        printf("    Score: %u points\n", PLAYER_SCORE(game_state, winner));
         printf("    Efficiency: %u valid moves, %u invalid moves\n",
-               game_state->players[winner].valid_moves,
-               game_state->players[winner].invalid_moves);
+               PLAYER_VALID_MOVES(game_state, winner),
+               PLAYER_INVALID_MOVES(game_state, winner));
         printf("%s", ANSI_RESET);
     }
     else
@@ -244,7 +267,8 @@ void show_final_winner(void)
     // Mostrar todos los jugadores ordenados por puntaje
     for (unsigned int i = 0; i < game_state->player_count; i++)
     {
-        player_t *p = &game_state->players[i];
+        player_t p;
+        get_player(game_state, i, &p);
 
         printf("%s", get_player_color(i));
         if (i == (unsigned int)winner)
@@ -257,10 +281,10 @@ void show_final_winner(void)
             printf("    ");
         }
 
-        printf("%-8s: %3u pts", p->name, p->score);
+        printf("%-8s: %3u pts", p.name, p.score);
 
         // Barra visual del score más bonita
-        int score_bars = p->score / SCORE_BAR_UNIT_FINAL;
+        int score_bars = p.score / SCORE_BAR_UNIT_FINAL;
         if (score_bars > SCORE_BAR_MAX_FINAL)
             score_bars = SCORE_BAR_MAX_FINAL;
         printf(" [");
@@ -285,6 +309,29 @@ void show_final_winner(void)
     fflush(stdout);
 }
 
+// Modo de salida por entorno; ante cualquier error se queda con ANSI en vez de salir, así el
+// máster no se queda esperando a una vista que no arrancó
+void setup_output(int width, int height)
+{
+    const char *output = getenv(VIEW_OUTPUT_ENV);
+    frame_output_t format = FRAME_OUTPUT_ANSI;
+    if (output && frame_output_parse(output, &format) == -1)
+        fprintf(stderr, "Unknown %s '%s' (ansi, ndjson, binary), using ansi\n", VIEW_OUTPUT_ENV, output);
+    if (format == FRAME_OUTPUT_ANSI)
+        return;
+
+    const char *every = getenv(VIEW_EVERY_ENV);
+    int every_n = every ? atoi(every) : 1;
+    if (frame_stream_open(&frame_stream, format, getenv(VIEW_FILE_ENV), every_n > 0 ? (unsigned int)every_n : 1,
+                          width, height) == -1)
+    {
+        fprintf(stderr, "Could not open the frame stream, using ansi\n");
+        return;
+    }
+    streaming = true;
+    signal(SIGPIPE, SIG_IGN); // Un lector que se va no mata a la vista: write devuelve EPIPE
+}
+
 int main(int argc, char *argv[])
 {
     // Inncesario pues el master les pasa correctamente los parametros
@@ -307,24 +354,39 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    trace_init("view");
     connect_shared_memory_view(width, height);
+    setup_output(width, height);
 
     while (true)
     {
         // Esperar notificación del máster
-        sem_wait(&game_sync->view_notify);
+        turn_wait(game_sync, TURN_SLOT_VIEW_NOTIFY);
 
         // Imprimir estado
-        print_board();
+        TRACE_BEGIN("frame");
+        if (streaming)
+        {
+            board_to_rowmajor(game_state, frame_cells);
+            frame_stream_frame(&frame_stream, game_state, frame_cells);
+        }
+        else
+            print_board();
+        TRACE_END("frame");
+
+        // Leer el flag antes de liberar al máster: después del post puede marcar el fin
+        // y esperar un frame más que ya nadie mostraría
+        bool game_finished = game_state->game_finished;
 
         // Notificar al máster que terminamos
-        sem_post(&game_sync->view_done);
+        turn_post(game_sync, TURN_SLOT_VIEW_DONE);
 
         // Salir si el juego terminó
-        if (game_state->game_finished)
+        if (game_finished)
         {
-            // Mostrar pantalla final con ganador
-            show_final_winner();
+            // Mostrar pantalla final con ganador (en el stream ya va en el último registro)
+            if (!streaming)
+                show_final_winner();
             break;
         }
     }